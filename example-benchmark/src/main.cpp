@@ -0,0 +1,81 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+// Times MTBackgroundSubstractionMedian against MTBackgroundSubstraction2 (MOG2) on the same frames.
+// The frames come from the test pattern source, so the numbers can be compared across machines and commits.
+// Usage: example-benchmark [width] [height] [frames]
+
+#include "ofMain.h"
+#include "MTVideoInputStream.hpp"
+#include "processes/MTBackgroundSubstraction2.hpp"
+#include "processes/MTBackgroundSubstractionMedian.hpp"
+#include "inputSources/MTVideoInputSourceTestPattern.hpp"
+
+namespace
+{
+	// MOG2 needs a few frames before its model settles, these are not timed:
+	const int WarmUpFrames = 30;
+
+	/**
+	 * @return Milliseconds per frame.
+	 */
+	double benchmark(const std::shared_ptr<MTVideoProcess>& process, const std::vector<cv::Mat>& frames,
+					 int measuredFrames)
+	{
+		process->setProcessSize(frames.front().cols, frames.front().rows);
+		MTProcessData processData;
+		uint64_t start = 0;
+		for (int i = 0; i < WarmUpFrames + measuredFrames; i++)
+		{
+			if (i == WarmUpFrames) start = ofGetElapsedTimeMicros();
+			processData.clear();
+			processData.processSource = frames[i % frames.size()];
+			processData.processStream = processData.processSource;
+			process->process(processData);
+		}
+		return (ofGetElapsedTimeMicros() - start) * 0.001 / measuredFrames;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	ofInit();
+	int width = argc > 1 ? ofToInt(argv[1]) : 640;
+	int height = argc > 2 ? ofToInt(argv[2]) : 480;
+	int measuredFrames = argc > 3 ? ofToInt(argv[3]) : 600;
+
+	// The scene pattern has moving blobs, noise, lighting changes and a static period:
+	auto source = std::make_shared<MTVideoInputSourceTestPattern>("Scene");
+	source->paced.set(false);
+	source->setup(width, height, 30, "Scene");
+	std::vector<cv::Mat> frames;
+	for (int i = 0; i < source->cycleLength.get(); i++)
+	{
+		source->update();
+		if (!source->isFrameNew()) continue;
+		// Both processes work on gray. Converting once here keeps the conversion out of the timing:
+		cv::Mat gray;
+		cv::cvtColor(source->getFrame().image, gray, cv::COLOR_RGB2GRAY);
+		frames.push_back(gray);
+	}
+	if (frames.empty())
+	{
+		ofLogError("benchmark") << "The test pattern did not deliver any frames";
+		return 1;
+	}
+
+	ofLogNotice("benchmark") << width << "x" << height << ", " << measuredFrames << " frames, "
+							 << cv::getNumThreads() << " threads";
+
+	double mog2 = benchmark(std::make_shared<MTBackgroundSubstraction2>(), frames, measuredFrames);
+	ofLogNotice("benchmark") << "MTBackgroundSubstraction2 (MOG2): " << mog2 << " ms/frame, "
+							 << 1000.0 / mog2 << " fps";
+
+	double median = benchmark(std::make_shared<MTBackgroundSubstractionMedian>(), frames, measuredFrames);
+	ofLogNotice("benchmark") << "MTBackgroundSubstractionMedian: " << median << " ms/frame, "
+							 << 1000.0 / median << " fps";
+
+	ofLogNotice("benchmark") << "Speedup: " << mog2 / median << "x";
+	return 0;
+}
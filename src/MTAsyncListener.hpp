@@ -0,0 +1,186 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTASYNCLISTENER_HPP
+#define NERVOUSSTRUCTUREOF_MTASYNCLISTENER_HPP
+
+#include <deque>
+#include <condition_variable>
+#include <utils/ofThread.h>
+#include "ofEvents.h"
+
+/**
+ * @brief What an MTAsyncListener does with a new event when its queue is full.
+ */
+enum class MTAsyncDropPolicy
+{
+	DropOldest,		// Discard the oldest queued event, the listener always gets the latest ones
+	DropNewest,		// Discard the new event
+	Block			// Make the notifying thread wait for room. Only use this if the listener must see every event
+};
+
+struct MTAsyncListenerStats
+{
+	uint64_t received = 0;
+	uint64_t delivered = 0;
+	uint64_t dropped = 0;
+	size_t queued = 0;
+	/**
+	 * @brief Time from notification to delivery of the last delivered event, in milliseconds.
+	 */
+	float lag = 0;
+	float maxLag = 0;
+};
+
+/**
+ * @brief Calls a listener on its own thread instead of on the thread that notifies the event, so that
+ * a slow listener (file writing, networking...) does not stall the stream. Events are copied into a
+ * bounded queue. The listener is unsubscribed and its thread stopped when this object is destroyed.
+ *
+ * The event arguments are copied, but cv::Mats in them still point to the notifier's data. Use the
+ * MTSharedFrame of MTVideoProcessCompleteEventArgs, or pass a prepare function that clones what you need.
+ * @tparam ArgsType The argument type of the event.
+ */
+template<typename ArgsType>
+class MTAsyncListener : public ofThread
+{
+public:
+	/**
+	 * @param callback Called on the listener's thread.
+	 * @param queueDepth How many events can wait for the listener.
+	 * @param policy What happens when queueDepth events are waiting.
+	 * @param prepare Optional, called on the notifying thread on the copy that is queued.
+	 */
+	MTAsyncListener(std::function<void(ArgsType&)> callback,
+					size_t queueDepth = 2,
+					MTAsyncDropPolicy policy = MTAsyncDropPolicy::DropOldest,
+					std::function<void(ArgsType&)> prepare = nullptr) :
+			callback(std::move(callback)),
+			prepare(std::move(prepare)),
+			queueDepth(std::max<size_t>(1, queueDepth)),
+			policy(policy)
+	{
+		setThreadName("MTAsyncListener");
+		startThread();
+	}
+
+	~MTAsyncListener()
+	{
+		listeners.unsubscribeAll();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopThread();
+		}
+		notEmpty.notify_all();
+		notFull.notify_all();
+		waitForThread(false);
+	}
+
+	/**
+	 * @brief Starts listening to event, which can be an ofEvent or an ofFastEvent with ArgsType arguments.
+	 * One async listener can subscribe to several events.
+	 */
+	template<typename EventType>
+	void subscribe(EventType& event)
+	{
+		listeners.push(event.newListener([this](ArgsType& args)
+										 {
+											 push(args);
+										 }));
+	}
+
+	/**
+	 * @brief Queues a copy of args. Called from the notifying thread.
+	 */
+	void push(const ArgsType& args)
+	{
+		// Decide whether the event is queued before paying for prepare:
+		std::unique_lock<std::mutex> lock(mutex);
+		stats.received++;
+		if (queue.size() >= queueDepth)
+		{
+			if (policy == MTAsyncDropPolicy::DropNewest)
+			{
+				stats.dropped++;
+				return;
+			}
+			if (policy == MTAsyncDropPolicy::Block)
+			{
+				notFull.wait(lock, [this]()
+				{
+					return queue.size() < queueDepth || !isThreadRunning();
+				});
+				if (!isThreadRunning()) return;
+			}
+		}
+		lock.unlock();
+
+		ArgsType copy = args;
+		if (prepare) prepare(copy);
+
+		lock.lock();
+		// DropOldest, or another event subscribed to this listener filled the queue while preparing:
+		if (queue.size() >= queueDepth)
+		{
+			queue.pop_front();
+			stats.dropped++;
+		}
+		queue.emplace_back(std::move(copy), ofGetElapsedTimeMicros());
+		stats.queued = queue.size();
+		lock.unlock();
+		notEmpty.notify_one();
+	}
+
+	/**
+	 * @brief Thread-safe.
+	 */
+	MTAsyncListenerStats getStats()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return stats;
+	}
+
+protected:
+	void threadedFunction() override
+	{
+		while (isThreadRunning())
+		{
+			// Event arguments are not necessarily default constructible:
+			std::unique_ptr<std::pair<ArgsType, uint64_t>> item;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				notEmpty.wait(lock, [this]()
+				{
+					return !queue.empty() || !isThreadRunning();
+				});
+				if (queue.empty()) continue;
+				item.reset(new std::pair<ArgsType, uint64_t>(std::move(queue.front())));
+				queue.pop_front();
+				stats.queued = queue.size();
+			}
+			notFull.notify_one();
+
+			callback(item->first);
+
+			float lag = (ofGetElapsedTimeMicros() - item->second) * 0.001f;
+			std::lock_guard<std::mutex> lock(mutex);
+			stats.delivered++;
+			stats.lag = lag;
+			stats.maxLag = std::max(stats.maxLag, lag);
+		}
+	}
+
+private:
+	std::function<void(ArgsType&)> callback;
+	std::function<void(ArgsType&)> prepare;
+	size_t queueDepth;
+	MTAsyncDropPolicy policy;
+	std::deque<std::pair<ArgsType, uint64_t>> queue;
+	std::condition_variable notEmpty;
+	std::condition_variable notFull;
+	MTAsyncListenerStats stats;
+	ofEventListeners listeners;
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTASYNCLISTENER_HPP
@@ -0,0 +1,72 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include "MTFrameHistory.hpp"
+
+void MTFrameHistory::setDepth(size_t depth)
+{
+	if (depth == ring.size()) return;
+	ring.clear();
+	ring.resize(depth);
+	head = 0;
+	count = 0;
+}
+
+void MTFrameHistory::push(const cv::Mat& stream, const cv::Mat& source)
+{
+	if (ring.empty()) return;
+
+	head = (head + 1) % ring.size();
+	auto& slot = ring[head];
+	store(stream, slot.stream);
+	if (source.empty())
+	{
+		slot.source.release();
+	}
+	else
+	{
+		store(source, slot.source);
+	}
+	count = std::min(count + 1, ring.size());
+}
+
+void MTFrameHistory::store(const cv::Mat& frame, cv::Mat& slot)
+{
+	// Someone outside of the ring is still holding this buffer, leave it to them:
+	if (slot.u != nullptr && slot.u->refcount > 1)
+	{
+		slot.release();
+	}
+	// Reuses the buffer if the size and type match:
+	frame.copyTo(slot);
+}
+
+const MTHistoryFrame* MTFrameHistory::get(size_t age) const
+{
+	if (age >= count) return nullptr;
+	return &ring[(head + ring.size() - age) % ring.size()];
+}
+
+cv::Mat MTFrameHistory::getStream(size_t age) const
+{
+	auto frame = get(age);
+	return frame != nullptr ? frame->stream : cv::Mat();
+}
+
+cv::Mat MTFrameHistory::getSource(size_t age) const
+{
+	auto frame = get(age);
+	return frame != nullptr ? frame->source : cv::Mat();
+}
+
+void MTFrameHistory::clear()
+{
+	for (auto& frame : ring)
+	{
+		frame.stream.release();
+		frame.source.release();
+	}
+	head = 0;
+	count = 0;
+}
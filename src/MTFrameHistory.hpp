@@ -0,0 +1,85 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTFRAMEHISTORY_HPP
+#define NERVOUSSTRUCTUREOF_MTFRAMEHISTORY_HPP
+
+#include <vector>
+#include "ofxCv.h"
+
+/**
+ * @brief A past frame of an MTVideoInputStream.
+ */
+struct MTHistoryFrame
+{
+	/**
+	 * @brief processStream as it entered the first process, at processing size.
+	 */
+	cv::Mat stream;
+	/**
+	 * @brief processSource at full input resolution. Empty unless the stream keeps source frames.
+	 */
+	cv::Mat source;
+};
+
+/**
+ * @brief A ring of the most recent frames of a stream, shared by all of its processes.
+ * Processes get shallow cv::Mat headers, so reading the history never copies.
+ * Buffers are recycled in place when no one else holds a reference to them. If a process
+ * keeps a Mat from the history past the current frame, the ring lets go of that buffer
+ * and allocates a new one, so the data that the process holds never changes under it.
+ * The history is written and read in the stream's processing thread, it is not meant to be
+ * accessed from anywhere else.
+ */
+class MTFrameHistory
+{
+public:
+	/**
+	 * @brief Sets how many frames are kept, including the current one. 0 disables the history.
+	 * Changing the depth discards the frames stored so far.
+	 */
+	void setDepth(size_t depth);
+	size_t getDepth() const { return ring.size(); }
+
+	/**
+	 * @brief The number of frames currently stored, at most getDepth().
+	 */
+	size_t getSize() const { return count; }
+
+	/**
+	 * @brief Copies the frame into the ring, overwriting the oldest frame.
+	 * @param source Can be empty if source frames are not needed.
+	 */
+	void push(const cv::Mat& stream, const cv::Mat& source);
+
+	/**
+	 * @param age 0 is the current frame, 1 the previous one, and so on.
+	 * @return The frame, or nullptr if the history does not reach that far back.
+	 */
+	const MTHistoryFrame* get(size_t age) const;
+
+	/**
+	 * @return The stream Mat of the frame at age, or an empty Mat if there is none.
+	 */
+	cv::Mat getStream(size_t age) const;
+
+	/**
+	 * @return The source Mat of the frame at age, or an empty Mat if there is none.
+	 */
+	cv::Mat getSource(size_t age) const;
+
+	/**
+	 * @brief Discards the stored frames. Call when the frame size changes.
+	 */
+	void clear();
+
+protected:
+	std::vector<MTHistoryFrame> ring;
+	size_t head = 0;
+	size_t count = 0;
+
+	static void store(const cv::Mat& frame, cv::Mat& slot);
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTFRAMEHISTORY_HPP
@@ -0,0 +1,50 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include "MTPointCloud.hpp"
+#include <opencv2/core/hal/intrin.hpp>
+
+void MTPointCloud::assignInterleaved(const float* xyz, size_t count)
+{
+	resize(count);
+	groundPlane = cv::Vec4f(0, 0, 0, 0);
+	size_t written = 0;
+	size_t i = 0;
+
+#if CV_SIMD128
+	const cv::v_float32x4 zero = cv::v_setzero_f32();
+	for (; i + 4 <= count; i += 4)
+	{
+		cv::v_float32x4 vx, vy, vz;
+		cv::v_load_deinterleave(xyz + i * 3, vx, vy, vz);
+		// Most blocks are entirely valid, those are stored as they are:
+		if (cv::v_check_all(vz > zero))
+		{
+			cv::v_store(&x[written], vx);
+			cv::v_store(&y[written], vy);
+			cv::v_store(&z[written], vz);
+			written += 4;
+			continue;
+		}
+		for (size_t k = i; k < i + 4; k++)
+		{
+			if (xyz[k * 3 + 2] <= 0) continue;
+			x[written] = xyz[k * 3];
+			y[written] = xyz[k * 3 + 1];
+			z[written] = xyz[k * 3 + 2];
+			written++;
+		}
+	}
+#endif
+	for (; i < count; i++)
+	{
+		if (xyz[i * 3 + 2] <= 0) continue;
+		x[written] = xyz[i * 3];
+		y[written] = xyz[i * 3 + 1];
+		z[written] = xyz[i * 3 + 2];
+		written++;
+	}
+
+	resize(written);
+}
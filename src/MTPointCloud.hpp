@@ -0,0 +1,57 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTPOINTCLOUD_HPP
+#define NERVOUSSTRUCTUREOF_MTPOINTCLOUD_HPP
+
+#include <vector>
+#include "ofxCv.h"
+
+/**
+ * @brief A point cloud stored as a structure of arrays: one contiguous buffer per coordinate,
+ * so processes can load 4 points per SIMD register without shuffling.
+ * Coordinates are in metres, in the camera's frame (x right, y down, z forward).
+ */
+struct MTPointCloud
+{
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+
+	/**
+	 * @brief The ground plane (a, b, c, d) with a * x + b * y + c * z + d = 0, normal pointing up
+	 * and unit length. All zeros if no process has found one yet.
+	 */
+	cv::Vec4f groundPlane = cv::Vec4f(0, 0, 0, 0);
+
+	size_t size() const
+	{ return x.size(); }
+
+	bool empty() const
+	{ return x.empty(); }
+
+	void resize(size_t count)
+	{
+		x.resize(count);
+		y.resize(count);
+		z.resize(count);
+	}
+
+	void clear()
+	{
+		resize(0);
+		groundPlane = cv::Vec4f(0, 0, 0, 0);
+	}
+
+	bool hasGroundPlane() const
+	{ return groundPlane != cv::Vec4f(0, 0, 0, 0); }
+
+	/**
+	 * @brief Fills the cloud from interleaved xyz triplets, i.e. rs2::points vertices.
+	 * Points with z <= 0 (no depth) are skipped.
+	 */
+	void assignInterleaved(const float* xyz, size_t count);
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTPOINTCLOUD_HPP
@@ -0,0 +1,63 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTSHAREDFRAME_HPP
+#define NERVOUSSTRUCTUREOF_MTSHAREDFRAME_HPP
+
+#include "ofxCv.h"
+
+/**
+ * @brief A read-only, refcounted handle to an image. Copying the handle never copies the data.
+ * When a process hands one out, it stops writing into that buffer for as long as any copy of the
+ * handle exists, so the frame stays valid after the next frame is processed.
+ */
+class MTSharedFrame
+{
+public:
+	MTSharedFrame() = default;
+
+	/**
+	 * @param image Shared, not copied.
+	 * @param lease Kept alive for as long as any copy of the frame. The producer uses it to know
+	 * whether the buffer is still being read.
+	 */
+	explicit MTSharedFrame(const cv::Mat& image, std::shared_ptr<void> lease = nullptr) :
+			image(std::make_shared<cv::Mat>(image)), lease(std::move(lease))
+	{}
+
+	/**
+	 * @brief The image. Don't modify it, other handles are looking at the same data.
+	 */
+	const cv::Mat& get() const
+	{
+		static const cv::Mat empty;
+		return image ? *image : empty;
+	}
+
+	/**
+	 * @brief Copy on write: clones the image unless this handle is the only one left and the producer
+	 * has let go of the buffer. Other copies of the handle keep the original data.
+	 */
+	cv::Mat& makeMutable()
+	{
+		if (image == nullptr) image = std::make_shared<cv::Mat>();
+		bool isShared = image.use_count() > 1 || (image->u != nullptr && image->u->refcount > 1);
+		if (isShared)
+		{
+			image = std::make_shared<cv::Mat>(image->clone());
+			lease = nullptr;
+		}
+		return *image;
+	}
+
+	bool empty() const
+	{ return image == nullptr || image->empty(); }
+
+private:
+	// Only ever modified through makeMutable(), after making sure nobody else sees it:
+	std::shared_ptr<cv::Mat> image;
+	std::shared_ptr<void> lease;
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTSHAREDFRAME_HPP
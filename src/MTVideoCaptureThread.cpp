@@ -0,0 +1,166 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include "MTVideoCaptureThread.hpp"
+
+MTVideoCaptureThread::MTVideoCaptureThread()
+{
+	setThreadName("MTVideoCaptureThread");
+}
+
+MTVideoCaptureThread::~MTVideoCaptureThread()
+{
+	stop();
+}
+
+void MTVideoCaptureThread::start(CaptureFunction capture, size_t ringSize, Policy policy)
+{
+	stop();
+	this->capture = std::move(capture);
+	this->policy = policy;
+	// A new ring every time, frames from the previous one may still be out:
+	ring = std::make_shared<Ring>();
+	ring->slots.resize(std::max<size_t>(2, ringSize));
+	startThread();
+}
+
+void MTVideoCaptureThread::stop()
+{
+	if (!isThreadRunning()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(ring->mutex);
+		ring->isStopping = true;
+		stopThread();
+	}
+	ring->slotFreed.notify_all();
+	waitForThread(false);
+}
+
+bool MTVideoCaptureThread::receive(MTVideoInputFrame& frame)
+{
+	if (ring == nullptr) return false;
+
+	std::lock_guard<std::mutex> lock(ring->mutex);
+	int index = -1;
+	for (int i = 0; i < (int) ring->slots.size(); i++)
+	{
+		auto& slot = ring->slots[i];
+		if (slot.state != Slot::Ready) continue;
+		bool isBetter = index < 0 ||
+						(policy == Latest ? slot.sequence > ring->slots[index].sequence :
+						 slot.sequence < ring->slots[index].sequence);
+		if (isBetter) index = i;
+	}
+	if (index < 0) return false;
+
+	if (policy == Latest)
+	{
+		// Older frames will never be received:
+		for (auto& slot : ring->slots)
+		{
+			if (slot.state == Slot::Ready && slot.sequence < ring->slots[index].sequence)
+			{
+				slot.state = Slot::Free;
+				ring->stats.dropped++;
+			}
+		}
+	}
+
+	auto& slot = ring->slots[index];
+	slot.state = Slot::Held;
+	ring->stats.delivered++;
+
+	frame.image = slot.image;
+	frame.captureTime = slot.captureTime;
+	auto r = ring;
+	frame.owner = std::shared_ptr<void>(new int(index), [r](void* p)
+	{
+		int index = *static_cast<int*>(p);
+		delete static_cast<int*>(p);
+		{
+			std::lock_guard<std::mutex> lock(r->mutex);
+			r->slots[index].state = Slot::Free;
+		}
+		r->slotFreed.notify_one();
+	});
+	ring->slotFreed.notify_one();
+	return true;
+}
+
+MTVideoCaptureThread::Stats MTVideoCaptureThread::getStats()
+{
+	if (ring == nullptr) return Stats();
+	std::lock_guard<std::mutex> lock(ring->mutex);
+	return ring->stats;
+}
+
+int MTVideoCaptureThread::acquireSlot()
+{
+	std::unique_lock<std::mutex> lock(ring->mutex);
+	while (!ring->isStopping)
+	{
+		int oldestReady = -1;
+		for (int i = 0; i < (int) ring->slots.size(); i++)
+		{
+			auto& slot = ring->slots[i];
+			if (slot.state == Slot::Free)
+			{
+				slot.state = Slot::Writing;
+				return i;
+			}
+			if (slot.state == Slot::Ready &&
+				(oldestReady < 0 || slot.sequence < ring->slots[oldestReady].sequence))
+			{
+				oldestReady = i;
+			}
+		}
+
+		// The stream is behind. Only the latest frame matters, so write over the oldest one:
+		if (policy == Latest && oldestReady >= 0)
+		{
+			ring->slots[oldestReady].state = Slot::Writing;
+			ring->stats.dropped++;
+			return oldestReady;
+		}
+
+		ring->slotFreed.wait(lock);
+	}
+	return -1;
+}
+
+void MTVideoCaptureThread::threadedFunction()
+{
+	while (isThreadRunning())
+	{
+		int index = acquireSlot();
+		if (index < 0) break;
+
+		// Slots are only written by this thread while in the Writing state:
+		cv::Mat& image = ring->slots[index].image;
+		// Someone kept a header of this buffer after giving the frame back:
+		if (image.u != nullptr && image.u->refcount > 1) image.release();
+		bool isCaptured = capture(image);
+		uint64_t captureTime = ofGetElapsedTimeMicros();
+
+		{
+			std::lock_guard<std::mutex> lock(ring->mutex);
+			auto& slot = ring->slots[index];
+			if (isCaptured)
+			{
+				slot.state = Slot::Ready;
+				slot.sequence = ++ring->sequence;
+				slot.captureTime = captureTime;
+				ring->stats.captured++;
+			}
+			else
+			{
+				slot.state = Slot::Free;
+			}
+		}
+
+		// Sources that poll for frames have nothing to do until the next one arrives:
+		if (!isCaptured) sleep(1);
+	}
+}
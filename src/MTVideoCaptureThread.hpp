@@ -0,0 +1,109 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTVIDEOCAPTURETHREAD_HPP
+#define NERVOUSSTRUCTUREOF_MTVIDEOCAPTURETHREAD_HPP
+
+#include <condition_variable>
+#include <utils/ofThread.h>
+#include "MTVideoInputSource.hpp"
+
+/**
+ * @brief Runs the capture of an input source on its own thread, so that capturing and decoding don't wait
+ * for processing and vice versa. Frames are captured into a fixed ring of buffers that are reused from
+ * frame to frame, and handed to the stream without a copy: a slot stays out of the ring for as long as
+ * the MTVideoInputFrame that was received from it is alive.
+ */
+class MTVideoCaptureThread : public ofThread
+{
+public:
+	enum Policy
+	{
+		/// The stream always gets the newest frame, older frames that were not received are dropped
+		Latest = 0,
+		/// The stream gets every frame in order. Capture waits when the ring is full, nothing is dropped
+		FIFO
+	};
+
+	/**
+	 * @brief Called on the capture thread. Writes the next frame into image, which can be reallocated.
+	 * @return false if there was no new frame.
+	 */
+	typedef std::function<bool(cv::Mat& image)> CaptureFunction;
+
+	struct Stats
+	{
+		uint64_t captured = 0;
+		uint64_t delivered = 0;
+		uint64_t dropped = 0;
+	};
+
+	MTVideoCaptureThread();
+	~MTVideoCaptureThread();
+
+	/**
+	 * @param ringSize Number of buffers. One is held by the stream and one is being written to,
+	 * so anything under 3 makes the capture wait for the stream.
+	 */
+	void start(CaptureFunction capture, size_t ringSize = 3, Policy policy = Latest);
+	void stop();
+
+	/**
+	 * @brief Takes the next frame according to the policy.
+	 * @return false if there is no new frame.
+	 */
+	bool receive(MTVideoInputFrame& frame);
+
+	/**
+	 * @brief Thread-safe.
+	 */
+	Stats getStats();
+
+protected:
+	void threadedFunction() override;
+
+private:
+	struct Slot
+	{
+		enum State
+		{
+			Free,
+			Writing,
+			Ready,
+			Held
+		};
+
+		cv::Mat image;
+		State state = Free;
+		uint64_t sequence = 0;
+		/// When capture() returned the frame, in microseconds of ofGetElapsedTimeMicros()
+		uint64_t captureTime = 0;
+	};
+
+	/**
+	 * @brief Shared with the frames that are out, which put their slot back in when they are released.
+	 * Also keeps the buffers alive if the frames outlive the capture thread.
+	 */
+	struct Ring
+	{
+		std::mutex mutex;
+		std::condition_variable slotFreed;
+		std::vector<Slot> slots;
+		uint64_t sequence = 0;
+		Stats stats;
+		bool isStopping = false;
+	};
+
+	std::shared_ptr<Ring> ring;
+	CaptureFunction capture;
+	Policy policy = Latest;
+
+	/**
+	 * @brief Finds a slot to write the next frame to.
+	 * @return -1 if stopping.
+	 */
+	int acquireSlot();
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTVIDEOCAPTURETHREAD_HPP
@@ -0,0 +1,310 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include "MTVideoInputCompositor.hpp"
+#include "MTVideoInputStream.hpp"
+
+MTVideoInputCompositor::MTVideoInputCompositor() : MTModel("Compositor")
+{
+	parameters.add(canvasSize.set("Canvas Size", glm::ivec2(1280, 720), glm::ivec2(16, 16), glm::ivec2(8192, 8192)),
+				   blendMode.set("Blend Mode", BlendMax, BlendMax, BlendAverage));
+	setThreadName("MTVideoInputCompositor");
+	startThread();
+}
+
+MTVideoInputCompositor::~MTVideoInputCompositor()
+{
+	clear();
+	{
+		std::lock_guard<std::mutex> lock(layersMutex);
+		stopThread();
+	}
+	condition.notify_all();
+	waitForThread(false);
+}
+
+void MTVideoInputCompositor::addStream(std::shared_ptr<MTVideoInputStream> stream,
+									   std::shared_ptr<MTVideoProcess> process)
+{
+	auto layer = std::make_shared<Layer>();
+	layer->stream = stream;
+	std::weak_ptr<Layer> weakLayer = layer;
+
+	if (process == nullptr)
+	{
+		layer->listener = stream->streamCompleteFastEvent.newListener(
+				[this, weakLayer](MTVideoInputStreamCompleteEventArgs& args)
+				{
+					if (auto layer = weakLayer.lock())
+					{
+						warpLayer(*layer, args.result, args.stream->getOutputToProcessTransform(),
+								  cv::Size(args.stream->getWidth(), args.stream->getHeight()));
+					}
+				});
+	}
+	else
+	{
+		std::weak_ptr<MTVideoInputStream> weakStream = stream;
+		layer->listener = process->processCompleteFastEvent.newListener(
+				[this, weakLayer, weakStream](const MTVideoProcessCompleteFastEventArgs<MTVideoProcess>& args)
+				{
+					auto layer = weakLayer.lock();
+					auto stream = weakStream.lock();
+					if (layer && stream)
+					{
+						warpLayer(*layer, args.processOutput, stream->getOutputToProcessTransform(),
+								  cv::Size(stream->getWidth(), stream->getHeight()));
+					}
+				});
+	}
+
+	std::lock_guard<std::mutex> lock(layersMutex);
+	layers.push_back(layer);
+}
+
+void MTVideoInputCompositor::removeStream(std::shared_ptr<MTVideoInputStream> stream)
+{
+	std::lock_guard<std::mutex> lock(layersMutex);
+	layers.erase(std::remove_if(layers.begin(), layers.end(), [&stream](const std::shared_ptr<Layer>& layer)
+	{
+		auto s = layer->stream.lock();
+		return s == nullptr || s == stream;
+	}), layers.end());
+	isDirty = true;
+	condition.notify_one();
+}
+
+void MTVideoInputCompositor::clear()
+{
+	std::lock_guard<std::mutex> lock(layersMutex);
+	layers.clear();
+}
+
+MTSharedFrame MTVideoInputCompositor::getComposite()
+{
+	std::lock_guard<std::mutex> lock(compositeMutex);
+	return composite;
+}
+
+void MTVideoInputCompositor::warpLayer(Layer& layer, const cv::Mat& result, const cv::Mat& outputToProcess,
+									   cv::Size processSize)
+{
+	if (result.empty()) return;
+
+	cv::Mat source;
+	switch (result.type())
+	{
+		case CV_8UC1:
+			source = result;
+			break;
+		case CV_8UC3:
+			cv::cvtColor(result, layer.gray, cv::COLOR_RGB2GRAY);
+			source = layer.gray;
+			break;
+		case CV_8UC4:
+			cv::cvtColor(result, layer.gray, cv::COLOR_RGBA2GRAY);
+			source = layer.gray;
+			break;
+		case CV_16UC1:
+			result.convertTo(layer.gray, CV_8U, 1.0 / 257.0);
+			source = layer.gray;
+			break;
+		default:
+			// i.e. optical flow, which has no meaning as a mask:
+			return;
+	}
+
+	// Results that are not at the processing size (i.e. a downsampled process) are scaled into it:
+	cv::Mat_<double> transform = outputToProcess;
+	if (source.size() != processSize && processSize.area() > 0)
+	{
+		cv::Mat_<double> scale = cv::Mat_<double>::eye(3, 3);
+		scale(0, 0) = double(source.cols) / processSize.width;
+		scale(1, 1) = double(source.rows) / processSize.height;
+		transform = scale * transform;
+	}
+
+	cv::Size canvas(canvasSize->x, canvasSize->y);
+	if (layer.transform.empty() || layer.sourceSize != source.size() || layer.canvas != canvas ||
+		cv::norm(layer.transform, transform, cv::NORM_INF) != 0)
+	{
+		buildTables(layer, transform, source.size(), canvas);
+	}
+
+	if (layer.rect.empty()) return;
+
+	// The compositor may still be reading the buffer we wrote two frames ago:
+	if (layer.warping.u != nullptr && layer.warping.u->refcount > 1) layer.warping.release();
+	cv::remap(source, layer.warping, layer.map1, layer.map2, cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar(0));
+
+	{
+		std::lock_guard<std::mutex> lock(layer.mutex);
+		cv::swap(layer.warping, layer.warped);
+		layer.warpedCoverage = layer.coverage;
+		layer.warpedRect = layer.rect;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(layersMutex);
+		isDirty = true;
+	}
+	condition.notify_one();
+}
+
+void MTVideoInputCompositor::buildTables(Layer& layer, const cv::Mat& outputToProcess, cv::Size sourceSize,
+										 cv::Size canvas)
+{
+	layer.transform = outputToProcess.clone();
+	layer.sourceSize = sourceSize;
+	layer.canvas = canvas;
+
+	// The footprint of the source on the canvas:
+	std::vector<cv::Point2f> corners = {cv::Point2f(0, 0),
+										cv::Point2f(sourceSize.width, 0),
+										cv::Point2f(sourceSize.width, sourceSize.height),
+										cv::Point2f(0, sourceSize.height)};
+	std::vector<cv::Point2f> footprint;
+	cv::perspectiveTransform(corners, footprint, outputToProcess.inv());
+	layer.rect = cv::boundingRect(footprint) & cv::Rect(0, 0, canvas.width, canvas.height);
+	if (layer.rect.empty())
+	{
+		layer.map1.release();
+		layer.map2.release();
+		layer.coverage.release();
+		return;
+	}
+
+	cv::Mat mapX(layer.rect.size(), CV_32FC1);
+	cv::Mat mapY(layer.rect.size(), CV_32FC1);
+	const cv::Mat_<double> h = outputToProcess;
+	for (int y = 0; y < layer.rect.height; y++)
+	{
+		auto mx = mapX.ptr<float>(y);
+		auto my = mapY.ptr<float>(y);
+		double cy = layer.rect.y + y;
+		for (int x = 0; x < layer.rect.width; x++)
+		{
+			double cx = layer.rect.x + x;
+			double w = h(2, 0) * cx + h(2, 1) * cy + h(2, 2);
+			w = w != 0 ? 1.0 / w : 0;
+			mx[x] = (float) ((h(0, 0) * cx + h(0, 1) * cy + h(0, 2)) * w);
+			my[x] = (float) ((h(1, 0) * cx + h(1, 1) * cy + h(1, 2)) * w);
+		}
+	}
+
+	// Fixed point tables are considerably faster to remap with:
+	cv::convertMaps(mapX, mapY, layer.map1, layer.map2, CV_16SC2);
+
+	cv::Mat ones(sourceSize, CV_8UC1, cv::Scalar(1));
+	// New buffer, the compositor may be reading the old one:
+	layer.coverage = cv::Mat();
+	cv::remap(ones, layer.coverage, layer.map1, layer.map2, cv::INTER_NEAREST, cv::BORDER_CONSTANT, cv::Scalar(0));
+}
+
+void MTVideoInputCompositor::threadedFunction()
+{
+	while (isThreadRunning())
+	{
+		{
+			std::unique_lock<std::mutex> lock(layersMutex);
+			condition.wait(lock, [this]()
+			{
+				return isDirty || !isThreadRunning();
+			});
+			if (!isThreadRunning()) break;
+			isDirty = false;
+		}
+
+		compose();
+	}
+}
+
+void MTVideoInputCompositor::compose()
+{
+	struct Snapshot
+	{
+		cv::Mat warped;
+		cv::Mat coverage;
+		cv::Rect rect;
+	};
+
+	std::vector<Snapshot> snapshots;
+	{
+		std::lock_guard<std::mutex> lock(layersMutex);
+		for (auto& layer : layers)
+		{
+			std::lock_guard<std::mutex> layerLock(layer->mutex);
+			if (layer->warped.empty()) continue;
+			snapshots.push_back({layer->warped, layer->warpedCoverage, layer->warpedRect});
+		}
+	}
+
+	cv::Size size(canvasSize->x, canvasSize->y);
+	// The last frame stays in composite, where getComposite() can still hand it out, so the next one
+	// is drawn into the frame before it. That one is reused only if no listener holds on to it:
+	std::swap(canvas, spareCanvas);
+	std::swap(canvasLease, spareLease);
+	if (canvas.size() != size || canvasLease.use_count() > 0)
+	{
+		canvas = cv::Mat(size, CV_8UC1);
+	}
+
+	const bool isAverage = blendMode == BlendAverage;
+	if (isAverage)
+	{
+		sum.create(size, CV_16UC1);
+		count.create(size, CV_16UC1);
+	}
+
+	cv::parallel_for_(cv::Range(0, size.height), [&](const cv::Range& range)
+	{
+		cv::Rect strip(0, range.start, size.width, range.size());
+		canvas(strip).setTo(cv::Scalar(0));
+		if (isAverage)
+		{
+			sum(strip).setTo(cv::Scalar(0));
+			count(strip).setTo(cv::Scalar(0));
+		}
+
+		for (const auto& snapshot : snapshots)
+		{
+			cv::Rect r = snapshot.rect & strip;
+			if (r.empty()) continue;
+			cv::Rect local(r.x - snapshot.rect.x, r.y - snapshot.rect.y, r.width, r.height);
+			if (isAverage)
+			{
+				cv::Mat sumRoi = sum(r);
+				cv::Mat countRoi = count(r);
+				cv::add(sumRoi, snapshot.warped(local), sumRoi, cv::noArray(), CV_16U);
+				cv::add(countRoi, snapshot.coverage(local), countRoi, cv::noArray(), CV_16U);
+			}
+			else
+			{
+				cv::Mat canvasRoi = canvas(r);
+				cv::max(canvasRoi, snapshot.warped(local), canvasRoi);
+			}
+		}
+
+		if (isAverage)
+		{
+			cv::Mat divisor;
+			cv::max(count(strip), 1, divisor);
+			cv::Mat canvasStrip = canvas(strip);
+			cv::divide(sum(strip), divisor, canvasStrip, 1, CV_8U);
+		}
+	}, std::max(1, size.height / 64));
+
+	auto lease = std::make_shared<char>(0);
+	canvasLease = lease;
+	MTSharedFrame frame(canvas, lease);
+	{
+		std::lock_guard<std::mutex> lock(compositeMutex);
+		composite = frame;
+	}
+
+	MTVideoInputCompositeEventArgs args;
+	args.composite = frame;
+	args.frameNumber = ++frameNumber;
+	ofNotifyEvent(compositeFastEvent, args, this);
+}
@@ -0,0 +1,121 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTVIDEOINPUTCOMPOSITOR_HPP
+#define NERVOUSSTRUCTUREOF_MTVIDEOINPUTCOMPOSITOR_HPP
+
+#include <condition_variable>
+#include <utils/ofThread.h>
+#include "MTModel.hpp"
+#include "ofxCv.h"
+#include "MTSharedFrame.hpp"
+
+class MTVideoInputStream;
+class MTVideoProcess;
+
+struct MTVideoInputCompositeEventArgs
+{
+	/**
+	 * @brief The stitched CV_8UC1 canvas. Stays valid for as long as you hold it.
+	 */
+	MTSharedFrame composite;
+	uint64_t frameNumber;
+};
+
+/**
+ * @brief Stitches the results of several streams into one output-space canvas, i.e. to combine the
+ * cameras of a floor projection into a single mask. Each stream's result is warped with its
+ * processToOutputTransform into the part of the canvas that its output region covers, using remap
+ * tables that are only rebuilt when the transform or the sizes change. Warps run on the streams' own
+ * threads as their frames complete, and the blend runs on the compositor thread in parallel strips.
+ * Results are converted to 8-bit single channel.
+ */
+class MTVideoInputCompositor : public MTModel,
+							   public ofThread
+{
+public:
+	enum BlendMode
+	{
+		BlendMax = 0,
+		BlendAverage
+	};
+
+	ofParameter<glm::ivec2> canvasSize;
+	ofParameter<int> blendMode;
+
+	/**
+	 * @brief Fires in the compositor thread once per composite.
+	 */
+	ofFastEvent<MTVideoInputCompositeEventArgs> compositeFastEvent;
+
+	MTVideoInputCompositor();
+	~MTVideoInputCompositor();
+
+	/**
+	 * @brief Adds stream to the canvas.
+	 * @param process If not null, the output of this process is used instead of the result of the stream.
+	 */
+	void addStream(std::shared_ptr<MTVideoInputStream> stream, std::shared_ptr<MTVideoProcess> process = nullptr);
+	void removeStream(std::shared_ptr<MTVideoInputStream> stream);
+	void clear();
+
+	/**
+	 * @brief The last composite. Thread-safe.
+	 */
+	MTSharedFrame getComposite();
+
+protected:
+	void threadedFunction() override;
+
+private:
+	struct Layer
+	{
+		std::weak_ptr<MTVideoInputStream> stream;
+		ofEventListener listener;
+		std::mutex mutex;
+		/// Canvas pixels covered by the stream, clipped to the canvas
+		cv::Rect rect;
+		/// Fixed point remap tables for rect
+		cv::Mat map1;
+		cv::Mat map2;
+		/// 1 where the stream covers the canvas, for the average
+		cv::Mat coverage;
+		cv::Mat transform;
+		cv::Size sourceSize;
+		cv::Size canvas;
+		/// Written by the stream thread
+		cv::Mat warping;
+		cv::Mat gray;
+		/// Read by the compositor thread, under mutex
+		cv::Mat warped;
+		cv::Mat warpedCoverage;
+		cv::Rect warpedRect;
+	};
+
+	std::vector<std::shared_ptr<Layer>> layers;
+	std::mutex layersMutex;
+	std::condition_variable condition;
+	bool isDirty = false;
+
+	cv::Mat canvas;
+	cv::Mat sum;
+	cv::Mat count;
+	MTSharedFrame composite;
+	/// The canvas of the frame before composite, drawn into next if nobody holds it. Every handle
+	/// of a published frame holds its lease
+	cv::Mat spareCanvas;
+	std::weak_ptr<void> spareLease;
+	std::weak_ptr<void> canvasLease;
+	std::mutex compositeMutex;
+	uint64_t frameNumber = 0;
+
+	/**
+	 * @brief Stream thread. Warps result into the layer, rebuilding the tables if needed.
+	 */
+	void warpLayer(Layer& layer, const cv::Mat& result, const cv::Mat& outputToProcess, cv::Size processSize);
+	void buildTables(Layer& layer, const cv::Mat& outputToProcess, cv::Size sourceSize, cv::Size canvas);
+	void compose();
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTVIDEOINPUTCOMPOSITOR_HPP
@@ -42,6 +42,31 @@ void MTVideoInputSource::deserialize(ofXml& serializer)
 	isDeserializing = false;
 }
 
+const ofShortPixels& MTVideoInputSource::getShortPixels()
+{
+	static const ofShortPixels empty;
+	return empty;
+}
+
+MTVideoInputFrame MTVideoInputSource::getFrame()
+{
+	MTVideoInputFrame frame;
+	if (isShortPixels())
+	{
+		const auto& shortPixels = getShortPixels();
+		frame.image = cv::Mat(shortPixels.getHeight(),
+							  shortPixels.getWidth(),
+							  CV_16UC(shortPixels.getNumChannels()),
+							  (void*) shortPixels.getData());
+	}
+	else
+	{
+		frame.image = ofxCv::toCv(static_cast<const ofPixels&>(getPixels()));
+	}
+	frame.captureTime = captureTime;
+	return frame;
+}
+
 void MTVideoInputSource::renderImGui(ofxImGui::Settings& settings)
 {
 	if (RenderImGuiDelegate)
@@ -8,10 +8,110 @@
 #include <stdio.h>
 #include "MTModel.hpp"
 #include "ofxCv.h"
+#include "MTPointCloud.hpp"
 #include "registry.h"
 #include "ImHelpers.h"
 
 class MTCaptureEventArgs;
+class MTProcessPrefixCache;
+
+/**
+ * @brief A frame handed from an input source to a stream. The image can be a header over memory that
+ * belongs to the source (i.e. a camera driver buffer), in which case owner keeps that memory alive for
+ * as long as the frame is held. Don't modify the image, clone it if you need to.
+ */
+struct MTVideoInputFrame
+{
+	enum Format
+	{
+		/// image is the whole frame, RGB, gray or 16-bit
+		Packed = 0,
+		/// yuv is a CV_8UC1 of height * 3 / 2 rows: the Y plane followed by the interleaved UV plane
+		NV12,
+		/// yuv is a CV_8UC2 of Y0 U Y1 V pairs
+		YUYV
+	};
+
+	/**
+	 * @brief For YUV formats, the luma of the frame as a CV_8UC1. For NV12 it is a header over the Y plane.
+	 */
+	cv::Mat image;
+	/**
+	 * @brief Keeps the memory of image alive. Empty if the memory belongs to the source's pixels,
+	 * which are only valid until the next call to update().
+	 */
+	std::shared_ptr<void> owner;
+	Format format = Packed;
+	/**
+	 * @brief When the frame was captured, in microseconds of ofGetElapsedTimeMicros(). 0 if the source
+	 * doesn't know.
+	 */
+	uint64_t captureTime = 0;
+	/**
+	 * @brief The frame as the source delivered it, for YUV formats. Empty for Packed.
+	 */
+	cv::Mat yuv;
+
+	bool isYUV() const
+	{ return format != Packed; }
+
+	/**
+	 * @brief Converts a YUV frame to RGB. Packed frames are copied as they are.
+	 */
+	void toRGB(cv::Mat& dst) const
+	{
+		switch (format)
+		{
+			case NV12:
+				cv::cvtColor(yuv, dst, cv::COLOR_YUV2RGB_NV12);
+				break;
+			case YUYV:
+				cv::cvtColor(yuv, dst, cv::COLOR_YUV2RGB_YUYV);
+				break;
+			default:
+				image.copyTo(dst);
+				break;
+		}
+	}
+
+	/**
+	 * @brief Sets yuv and points image at its luma. NV12 needs no copy, the luma of YUYV is extracted
+	 * into lumaBuffer.
+	 */
+	void setYUV(const cv::Mat& frame, Format yuvFormat, cv::Mat& lumaBuffer)
+	{
+		format = yuvFormat;
+		yuv = frame;
+		if (format == NV12)
+		{
+			image = yuv.rowRange(0, yuv.rows * 2 / 3);
+		}
+		else
+		{
+			cv::extractChannel(yuv, lumaBuffer, 0);
+			image = lumaBuffer;
+		}
+	}
+
+	/**
+	 * @brief A deep copy that owns its memory.
+	 */
+	MTVideoInputFrame clone() const
+	{
+		MTVideoInputFrame copy;
+		if (format == Packed)
+		{
+			copy.image = image.clone();
+		}
+		else
+		{
+			cv::Mat luma;
+			copy.setYUV(yuv.clone(), format, luma);
+		}
+		copy.captureTime = captureTime;
+		return copy;
+	}
+};
 
 class MTVideoInputSource :
 		public std::enable_shared_from_this<MTVideoInputSource>, public MTModel
@@ -33,6 +133,40 @@ public:
 
 	virtual bool isFrameNew() = 0;
 	virtual const ofPixels& getPixels() = 0;
+
+	/**
+	 * @brief Whether the current frame is 16-bit, e.g. a depth frame. If it is, the frame
+	 * is in getShortPixels() instead of getPixels().
+	 */
+	virtual bool isShortPixels()
+	{ return false; }
+
+	/**
+	 * @brief The current frame of sources that deliver 16-bit data. Only valid when isShortPixels() is true.
+	 */
+	virtual const ofShortPixels& getShortPixels();
+
+	/**
+	 * @brief The current frame as a cv::Mat, without copying. The default implementation wraps
+	 * getPixels() or getShortPixels(). Sources that can hand out their own buffers override this.
+	 */
+	virtual MTVideoInputFrame getFrame();
+
+	/**
+	 * @brief Fills cloud with the points of the current frame.
+	 * @return false if the source does not produce point clouds, or not in its current mode.
+	 */
+	virtual bool getPointCloud(MTPointCloud& cloud)
+	{ return false; }
+
+	/**
+	 * @brief For sources that are read by more than one stream, where the streams can share the results
+	 * of the processes they have in common. See MTVideoInputSourceShared.
+	 * @param frameNumber Set to the number of the current frame, which identifies the frame in the cache.
+	 * @return nullptr if the source is not shared.
+	 */
+	virtual MTProcessPrefixCache* getProcessPrefixCache(uint64_t& frameNumber)
+	{ return nullptr; }
 	virtual void start() = 0;
 
 	virtual void close()
@@ -73,6 +207,11 @@ public:
 protected:
 	bool isDeserializing = false;
 	bool isSetupFlag = true;
+	/**
+	 * @brief When the current frame was captured, see MTVideoInputFrame::captureTime. Sources that use the
+	 * default getFrame() set it in update() when a new frame comes in.
+	 */
+	uint64_t captureTime = 0;
 private:
 	std::atomic_bool running;
 };
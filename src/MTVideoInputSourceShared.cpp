@@ -0,0 +1,215 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include "MTVideoInputSourceShared.hpp"
+
+#pragma mark MTProcessPrefixCache
+
+size_t MTProcessPrefixCache::find(uint64_t frameNumber, const std::vector<std::string>& keys,
+								  std::vector<Entry>& found)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	advance(frameNumber);
+	found.clear();
+	if (frameNumber == currentFrame)
+	{
+		for (const auto& key : keys)
+		{
+			auto iter = entries.find(key);
+			if (iter == entries.end()) break;
+			found.push_back(iter->second);
+		}
+	}
+
+	// Let the other streams know that these results are worth keeping:
+	wanted.insert(keys.begin(), keys.end());
+	return found.size();
+}
+
+void MTProcessPrefixCache::store(uint64_t frameNumber, const std::string& key, const Entry& entry)
+{
+	{
+		// Nobody has asked for it, don't pay for the copy:
+		std::lock_guard<std::mutex> lock(mutex);
+		if (wanted.count(key) == 0 && previouslyWanted.count(key) == 0) return;
+	}
+
+	Entry copy;
+	copy.processStream = entry.processStream.clone();
+	// The result is often the same Mat as the stream:
+	copy.processResult = entry.processResult.data == entry.processStream.data ?
+						 copy.processStream : entry.processResult.clone();
+	copy.processMask = entry.processMask.clone();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	// Streams can be a frame apart, don't let a late one wipe out the entries of a newer frame:
+	if (frameNumber < currentFrame) return;
+	advance(frameNumber);
+	entries[key] = std::move(copy);
+}
+
+void MTProcessPrefixCache::advance(uint64_t frameNumber)
+{
+	if (frameNumber <= currentFrame) return;
+	entries.clear();
+	// Only the keys that were looked up in the last frame are still worth keeping. Keys embed the
+	// parameters, so the ones from old settings are forgotten instead of piling up:
+	previouslyWanted = std::move(wanted);
+	wanted.clear();
+	currentFrame = frameNumber;
+}
+
+#pragma mark MTVideoInputSourceShared::Core
+
+MTVideoInputSourceShared::Core::Core(std::shared_ptr<MTVideoInputSource> source) : source(std::move(source))
+{}
+
+MTVideoInputSourceShared::Core::~Core()
+{
+	source->close();
+}
+
+void MTVideoInputSourceShared::Core::start()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (isStarted) return;
+	source->start();
+	isStarted = true;
+}
+
+void MTVideoInputSourceShared::Core::setup(int width, int height, int framerate, std::string deviceID)
+{
+	auto describe = [](int width, int height, int framerate, const std::string& deviceID)
+	{
+		return ofToString(width) + "x" + ofToString(height) + "@" + ofToString(framerate) + " " + deviceID;
+	};
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto settings = describe(width, height, framerate, deviceID);
+	if (settings == requestedSettings || settings == resolvedSettings) return;
+	source->setup(width, height, framerate, deviceID);
+	requestedSettings = settings;
+	resolvedSettings = describe(source->captureSize->x, source->captureSize->y, source->frameRate,
+								source->deviceID);
+}
+
+void MTVideoInputSourceShared::Core::update()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	source->update();
+	if (!source->isFrameNew()) return;
+
+	frame = source->getFrame();
+	// Pixels that belong to the source are overwritten by its next update, which may come from
+	// another stream while this frame is still being processed:
+	if (frame.owner == nullptr && !frame.image.empty())
+	{
+		frame = frame.clone();
+	}
+
+	if (pointCloud == nullptr || pointCloud.use_count() > 1)
+	{
+		pointCloud = std::make_shared<MTPointCloud>();
+	}
+	hasPointCloud = source->getPointCloud(*pointCloud);
+	frameNumber++;
+}
+
+#pragma mark MTVideoInputSourceShared
+
+MTVideoInputSourceShared::MTVideoInputSourceShared(std::shared_ptr<Core> core) :
+		MTVideoInputSource(core->source->getName(),
+						   core->source->getTypeName(),
+						   core->source->friendlyTypeName.get(),
+						   core->source->deviceID.get()),
+		core(core)
+{
+	// All the streams show and save the settings of the shared source, and the wrapper's settings are
+	// the source's own, i.e. so that a deviceID that was not found can be replaced after deserializing:
+	parameters = core->source->getParameters();
+	deviceID.makeReferenceTo(core->source->deviceID);
+	captureSize.makeReferenceTo(core->source->captureSize);
+	frameRate.makeReferenceTo(core->source->frameRate);
+	isSetupFlag = core->source->isSetup();
+}
+
+bool MTVideoInputSourceShared::isFrameNew()
+{
+	std::lock_guard<std::mutex> lock(core->mutex);
+	if (core->frameNumber == frameNumber) return false;
+	frameNumber = core->frameNumber;
+	frame = core->frame;
+	pointCloud = core->pointCloud;
+	hasPointCloud = core->hasPointCloud;
+	return true;
+}
+
+const ofPixels& MTVideoInputSourceShared::getPixels()
+{
+	std::lock_guard<std::mutex> lock(core->mutex);
+	return core->source->getPixels();
+}
+
+bool MTVideoInputSourceShared::isShortPixels()
+{
+	return frame.image.depth() == CV_16U;
+}
+
+const ofShortPixels& MTVideoInputSourceShared::getShortPixels()
+{
+	std::lock_guard<std::mutex> lock(core->mutex);
+	return core->source->getShortPixels();
+}
+
+MTVideoInputFrame MTVideoInputSourceShared::getFrame()
+{
+	return frame;
+}
+
+bool MTVideoInputSourceShared::getPointCloud(MTPointCloud& cloud)
+{
+	if (!hasPointCloud || pointCloud == nullptr) return false;
+	cloud = *pointCloud;
+	return true;
+}
+
+MTProcessPrefixCache* MTVideoInputSourceShared::getProcessPrefixCache(uint64_t& frameNumber)
+{
+	// Nobody to share the results with:
+	if (core.use_count() < 2) return nullptr;
+	frameNumber = this->frameNumber;
+	return &core->prefixCache;
+}
+
+void MTVideoInputSourceShared::start()
+{
+	core->start();
+}
+
+void MTVideoInputSourceShared::update()
+{
+	core->update();
+}
+
+void MTVideoInputSourceShared::setup()
+{
+	auto& source = core->source;
+	core->setup(source->captureSize->x, source->captureSize->y, source->frameRate, source->deviceID);
+}
+
+void MTVideoInputSourceShared::setup(int width, int height, int framerate, std::string deviceID)
+{
+	core->setup(width, height, framerate, deviceID);
+}
+
+void MTVideoInputSourceShared::renderImGui(ofxImGui::Settings& settings)
+{
+	core->source->renderImGui(settings);
+}
+
+void MTVideoInputSourceShared::deserialize(ofXml& serializer)
+{
+	std::lock_guard<std::mutex> lock(core->mutex);
+	core->source->deserialize(serializer);
+}
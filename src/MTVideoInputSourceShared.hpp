@@ -0,0 +1,130 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTVIDEOINPUTSOURCESHARED_HPP
+#define NERVOUSSTRUCTUREOF_MTVIDEOINPUTSOURCESHARED_HPP
+
+#include <unordered_map>
+#include <unordered_set>
+#include "MTVideoInputSource.hpp"
+
+/**
+ * @brief The results of the stateless processes at the start of a stream, keyed by the signatures of
+ * those processes, so that streams sharing a source can skip the processes that another stream has
+ * already run on the same frame. Only holds the entries of the current frame.
+ */
+class MTProcessPrefixCache
+{
+public:
+	struct Entry
+	{
+		cv::Mat processStream;
+		cv::Mat processResult;
+		cv::Mat processMask;
+	};
+
+	/**
+	 * @brief Looks up the results of each step of a prefix, keys[i] being the key after step i.
+	 * @return The number of leading steps found, whose results are in found. The steps that were
+	 * looked up are marked as wanted.
+	 */
+	size_t find(uint64_t frameNumber, const std::vector<std::string>& keys, std::vector<Entry>& found);
+	/**
+	 * @brief Only keeps keys that some stream has looked for. The Mats are cloned, the stream that
+	 * computed them keeps writing into its buffers.
+	 */
+	void store(uint64_t frameNumber, const std::string& key, const Entry& entry);
+
+private:
+	std::mutex mutex;
+	uint64_t currentFrame = 0;
+	std::unordered_map<std::string, Entry> entries;
+	/// Keys that a stream looked up in this frame and in the one before
+	std::unordered_set<std::string> wanted;
+	std::unordered_set<std::string> previouslyWanted;
+
+	/// Starts a new frame if frameNumber is newer. The mutex must be held
+	void advance(uint64_t frameNumber);
+};
+
+/**
+ * @brief A source that is opened once and read by several streams. MTVideoInput::createInputSource returns
+ * an MTVideoInputSourceShared for every stream that asks for the same type and device ID, all of them
+ * reading from the same MTVideoInputSourceShared::Core. The device is closed when the last one is destroyed.
+ *
+ * Frames are handed to every stream by reference. Frames that the source does not keep alive itself
+ * (see MTVideoInputFrame::owner) are copied once per capture, not once per stream.
+ */
+class MTVideoInputSourceShared : public MTVideoInputSource
+{
+public:
+	class Core
+	{
+	public:
+		Core(std::shared_ptr<MTVideoInputSource> source);
+		~Core();
+
+		/**
+		 * @brief Polls the source. Any of the streams can do it, whichever gets there first.
+		 */
+		void update();
+		void start();
+		/**
+		 * @brief Sets the source up the first time, and again only if the settings change. Streams
+		 * that attach to a source that is already running don't interrupt it.
+		 */
+		void setup(int width, int height, int framerate, std::string deviceID);
+
+		std::shared_ptr<MTVideoInputSource> source;
+		MTProcessPrefixCache prefixCache;
+		std::mutex mutex;
+		MTVideoInputFrame frame;
+		std::shared_ptr<MTPointCloud> pointCloud;
+		bool hasPointCloud = false;
+		uint64_t frameNumber = 0;
+
+	private:
+		bool isStarted = false;
+		/// The settings of the last setup, as they were asked for and as the source resolved them
+		std::string requestedSettings;
+		std::string resolvedSettings;
+	};
+
+	MTVideoInputSourceShared(std::shared_ptr<Core> core);
+
+	bool isFrameNew() override;
+	const ofPixels& getPixels() override;
+	bool isShortPixels() override;
+	const ofShortPixels& getShortPixels() override;
+	MTVideoInputFrame getFrame() override;
+	bool getPointCloud(MTPointCloud& cloud) override;
+	MTProcessPrefixCache* getProcessPrefixCache(uint64_t& frameNumber) override;
+	void start() override;
+	void update() override;
+	void setup() override;
+	void setup(int width, int height, int framerate, std::string deviceID) override;
+	void renderImGui(ofxImGui::Settings& settings) override;
+	void deserialize(ofXml& serializer) override;
+
+	/**
+	 * @brief The source that is being shared.
+	 */
+	std::shared_ptr<MTVideoInputSource> getSource()
+	{ return core->source; }
+
+	/**
+	 * @brief How many streams are reading from the source.
+	 */
+	long getShareCount()
+	{ return core.use_count(); }
+
+private:
+	std::shared_ptr<Core> core;
+	MTVideoInputFrame frame;
+	std::shared_ptr<MTPointCloud> pointCloud;
+	bool hasPointCloud = false;
+	uint64_t frameNumber = 0;
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTVIDEOINPUTSOURCESHARED_HPP
@@ -12,6 +12,7 @@
 #include "MTApp.hpp"
 #include "MTVideoInputSource.hpp"
 #include "MTVideoInputStream.hpp"
+#include "MTVideoInputSourceShared.hpp"
 #include "MTAppFrameworkUtils.hpp"
 
 
@@ -25,6 +26,8 @@ MTVideoInputStream::MTVideoInputStream(std::string name) : MTModel(name)
 //									processingHeight.set("Process Height", 240, 80, 1080),
 						processingSize.set("Processing Size", 1.0, 0.1, 1.0),
 						useROI.set("Use ROI", false),
+						historyDepth.set("History Depth", 0, 0, 30),
+						historyIncludesSource.set("History Includes Source", false),
 						outputRegion.set("Output Region", ofPath()),
 						inputROI.set("Input ROI", ofPath()));
 	processesParameters.setName("Video Processes");
@@ -63,6 +66,22 @@ MTVideoInputStream::MTVideoInputStream(std::string name) : MTModel(name)
 																  }
 															  }));
 
+	addEventListener(historyDepth.newListener([this](int val)
+															{
+																enqueueFunction([this, val]()
+																					 {
+																						 frameHistory.setDepth(val);
+																					 });
+															}));
+
+	addEventListener(historyIncludesSource.newListener([this](bool val)
+																		 {
+																			 enqueueFunction([this]()
+																								  {
+																									  frameHistory.clear();
+																								  });
+																		 }));
+
 //	addEventListener(outputRegion.newListener([this](ofPath& val) {
 //		updateTransformInternals();
 //	}));
@@ -87,8 +106,9 @@ void MTVideoInputStream::setProcessingSize(float val)
 	}
 	processingWidth = floor((float) inputWidth * processingSize);
 	processingHeight = floor((float) inputHeight * processingSize);
-	workingImage.create(processingHeight, processingWidth, CV_8UC1);
+	workingImage.create(processingHeight, processingWidth, inputType);
 	processOutput.create(processingHeight, processingWidth, CV_8UC1);
+	frameHistory.clear();
 	for (const auto& p : videoProcesses)
 	{
 		p->setProcessSize(processingWidth, processingHeight);
@@ -103,12 +123,84 @@ MTVideoInputStream::~MTVideoInputStream()
 	closeStream();
 }
 
+void MTVideoInputStream::prepareImage(cv::Mat& image, cv::Mat& flipBuffer, cv::Mat& working)
+{
+	cv::Size processSize(processingWidth, processingHeight);
+
+	// The frame can be a view of the source's own memory, so it is never flipped in place:
+	if (mirrorVideo.get() && flipVideo.get())
+	{
+		cv::flip(image, flipBuffer, -1);
+		image = flipBuffer;
+	}
+	else if (mirrorVideo.get())
+	{
+		cv::flip(image, flipBuffer, 0);
+		image = flipBuffer;
+	}
+	else if (flipVideo.get())
+	{
+		cv::flip(image, flipBuffer, 1);
+		image = flipBuffer;
+	}
+
+	if (processingSize != 1.0f)
+	{
+		cv::resize(image, working, processSize);
+	}
+	else
+	{
+		working = image;
+	}
+
+	if (useROI)
+	{
+		cv::Mat result;
+		cv::warpPerspective(working,
+							result,
+							roiToProcessTransform,
+							processSize);
+		working = result;
+	}
+}
+
+std::string MTVideoInputStream::getPreparationSignature()
+{
+	std::stringstream stream;
+	stream << mirrorVideo.get() << flipVideo.get() << " " << processingWidth << "x" << processingHeight;
+	if (useROI) stream << " " << roiToProcessTransform;
+	stream << "|";
+	return stream.str();
+}
+
 void MTVideoInputStream::threadedFunction()
 {
 	setThreadName(this->getName());
 
 	MTProcessData processData;
 
+	// Only runs if a process asks for color. YUV frames are converted here, once per frame, and go through
+	// the same flip, resize and ROI as the luma. Other frames already are the color image:
+	auto colorConverter = [this](cv::Mat& source, cv::Mat& stream)
+	{
+		if (!currentFrame.isYUV())
+		{
+			source = videoInputImage;
+			stream = workingImage;
+			return;
+		}
+
+		// Processes may have held on to last frame's color:
+		for (auto buffer : {&colorInputImage, &colorFlippedImage, &colorWorkingImage})
+		{
+			if (buffer->u != nullptr && buffer->u->refcount > 1) buffer->release();
+		}
+		currentFrame.toRGB(colorInputImage);
+		source = colorInputImage;
+		prepareImage(source, colorFlippedImage, colorWorkingImage);
+		stream = colorWorkingImage;
+	};
+
 	while (isThreadRunning())
 	{
 		if (!isSetup || inputSource == nullptr)
@@ -128,53 +220,40 @@ void MTVideoInputStream::threadedFunction()
 		inputSource->update();
 		if (inputSource->isFrameNew())
 		{
-			auto pixels = inputSource->getPixels();
-			if (pixels.getWidth() != inputWidth || pixels.getHeight() != inputHeight)
+			// Holding on to the frame keeps the source's buffer alive until the next frame replaces it.
+			// 16-bit sources (i.e. depth) come through without any conversion:
+			currentFrame = inputSource->getFrame();
+			videoInputImage = currentFrame.image;
+			// Sources that don't know when their frame was captured get the time it reached the stream:
+			uint64_t captureTime = currentFrame.captureTime > 0 ? currentFrame.captureTime : ofGetElapsedTimeMicros();
+
+			// A process may have held on to the last point cloud, in which case it is left to it:
+			processData.pointCloud = nullptr;
+			if (pointCloud == nullptr || pointCloud.use_count() > 1)
 			{
-				inputWidth = pixels.getWidth();
-				inputHeight = pixels.getHeight();
-				setProcessingSize(processingSize);
+				pointCloud = std::make_shared<MTPointCloud>();
 			}
+			bool hasPointCloud = inputSource->getPointCloud(*pointCloud);
 
-			cv::Size processSize(processingWidth, processingHeight);
 			fpsCounter.newFrame();
-			videoInputImage = ofxCv::toCv(static_cast<const ofPixels&>(inputSource->getPixels()));
 
-			if (mirrorVideo.get() && flipVideo.get())
+			// Sources in point cloud mode may not deliver an image:
+			if (videoInputImage.empty())
 			{
-				cv::flip(videoInputImage, videoInputImage, -1);
+				workingImage = cv::Mat();
 			}
 			else
 			{
-				if (mirrorVideo.get())
+				if (videoInputImage.cols != inputWidth || videoInputImage.rows != inputHeight ||
+					videoInputImage.type() != inputType)
 				{
-					cv::flip(videoInputImage, videoInputImage, 0);
+					inputWidth = videoInputImage.cols;
+					inputHeight = videoInputImage.rows;
+					inputType = videoInputImage.type();
+					setProcessingSize(processingSize);
 				}
 
-				if (flipVideo.get())
-				{
-					cv::flip(videoInputImage, videoInputImage, 1);
-				}
-			}
-
-
-			if (processingSize != 1.0f)
-			{
-				cv::resize(videoInputImage, workingImage, processSize);
-			}
-			else
-			{
-				workingImage = videoInputImage;
-			}
-
-			if (useROI)
-			{
-				cv::Mat result;
-				cv::warpPerspective(workingImage,
-										  result,
-										  roiToProcessTransform,
-										  processSize);
-				workingImage = result;
+				prepareImage(videoInputImage, flippedImage, workingImage);
 			}
 
 			if (isRunning)
@@ -182,13 +261,70 @@ void MTVideoInputStream::threadedFunction()
 				processData.clear();
 				processData.processSource = videoInputImage;
 				processData.processStream = workingImage;
+				frameHistory.push(workingImage, historyIncludesSource ? videoInputImage : cv::Mat());
+				processData.history = frameHistory.getDepth() > 0 ? &frameHistory : nullptr;
+				processData.pointCloud = hasPointCloud ? pointCloud : nullptr;
+				processData.colorConverter = colorConverter;
+
+				// Streams reading from the same source share the results of the stateless processes
+				// at the start of their chains. Skip the ones another stream has already run on this frame:
+				uint64_t sharedFrame = 0;
+				auto prefixCache = inputSource->getProcessPrefixCache(sharedFrame);
+				size_t first = 0;
+				std::vector<std::pair<size_t, std::string>> prefix;
+				if (prefixCache != nullptr)
+				{
+					// Streams that prepare the frame differently don't have the same input:
+					std::string key = getPreparationSignature();
+					std::vector<std::string> keys;
+					for (size_t i = 0; i < videoProcesses.size(); i++)
+					{
+						auto& p = videoProcesses[i];
+						if (!p->isActive) continue;
+						if (!p->isStateless()) break;
+						key += p->getSignature();
+						prefix.emplace_back(i, key);
+						keys.push_back(key);
+					}
+
+					// The skipped processes still publish their output, to their UI and listeners:
+					std::vector<MTProcessPrefixCache::Entry> cached;
+					size_t found = prefixCache->find(sharedFrame, keys, cached);
+					for (size_t j = 0; j < found; j++)
+					{
+						auto& p = videoProcesses[prefix[j].first];
+						processData.processStream = cached[j].processStream;
+						processData.processResult = cached[j].processResult;
+						processData.processMask = cached[j].processMask;
+						p->recycleBuffers();
+						p->setCachedOutput(cached[j].processResult);
+						p->notifyEvents();
+					}
+					if (found > 0) first = prefix[found - 1].first + 1;
+				}
 
-				for (auto p : videoProcesses)
+				for (size_t i = first; i < videoProcesses.size(); i++)
 				{
+					auto& p = videoProcesses[i];
 					if (p->isActive)
 					{
+						if (processData.processStream.empty() && p->needsImage()) continue;
+
+						p->recycleBuffers();
 						p->process(processData);
 						p->notifyEvents();
+
+						if (prefixCache != nullptr && !prefix.empty() && i <= prefix.back().first)
+						{
+							auto key = std::find_if(prefix.begin(), prefix.end(),
+													[i](const std::pair<size_t, std::string>& entry)
+													{
+														return entry.first == i;
+													});
+							prefixCache->store(sharedFrame, key->second, {processData.processStream,
+																		  processData.processResult,
+																		  processData.processMask});
+						}
 					}
 
 				}
@@ -198,6 +334,8 @@ void MTVideoInputStream::threadedFunction()
 				eventArgs.input = videoInputImage;
 				eventArgs.result = processData.processResult;
 				eventArgs.fps = fpsCounter.getFps();
+				eventArgs.captureTime = captureTime;
+				eventArgs.frameNumber = ++frameNumber;
 				streamCompleteFastEvent.notify(this, eventArgs);
 				streamCompleteEvent.notify(this, eventArgs);
 			}
@@ -211,7 +349,8 @@ void MTVideoInputStream::threadedFunction()
 
 void MTVideoInputStream::setup()
 {
-	workingImage.create(processingHeight, processingWidth, CV_8UC1);
+	frameHistory.setDepth(historyDepth);
+	workingImage.create(processingHeight, processingWidth, inputType);
 	processOutput.create(processingHeight, processingWidth, CV_8UC1);
 
 	updateTransformInternals();
@@ -272,6 +411,20 @@ void MTVideoInputStream::setStreamRunning(bool _isRunning)
 //	return worldToProcessTransform;
 //}
 
+std::shared_ptr<MTAsyncListener<MTVideoInputStreamCompleteEventArgs>>
+MTVideoInputStream::addAsyncListener(std::function<void(MTVideoInputStreamCompleteEventArgs&)> callback,
+									 size_t queueDepth, MTAsyncDropPolicy policy)
+{
+	auto listener = std::make_shared<MTAsyncListener<MTVideoInputStreamCompleteEventArgs>>(
+			std::move(callback), queueDepth, policy, [](MTVideoInputStreamCompleteEventArgs& args)
+			{
+				args.input = args.input.clone();
+				args.result = args.result.clone();
+			});
+	listener->subscribe(streamCompleteFastEvent);
+	return listener;
+}
+
 cv::Mat MTVideoInputStream::getProcessToOutputTransform()
 {
 //	ofScopedLock lock(this->mutex);
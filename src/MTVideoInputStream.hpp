@@ -13,6 +13,7 @@
 #include "ofxCv.h"
 #include "MTVideoProcess.hpp"
 #include "MTVideoInputSource.hpp"
+#include "MTFrameHistory.hpp"
 #include "ofxMTVideoInput.h"
 
 
@@ -36,6 +37,15 @@ public:
  * @brief The current frames per second reading of the stream.
  */
 	 double fps;
+/**
+ * @brief When the frame was captured, in microseconds of ofGetElapsedTimeMicros(). Comparable across streams.
+ * See MTVideoInputFrame::captureTime, sources that don't provide it get the time the stream took the frame.
+ */
+	 uint64_t captureTime = 0;
+/**
+ * @brief Counts the frames processed by the stream, starting at 1.
+ */
+	 uint64_t frameNumber = 0;
 };
 
 class MTVideoInputStream : public MTModel,
@@ -65,14 +75,24 @@ public:
 	 ofReadOnlyParameter<ofPath, MTVideoInputStream> inputROI;
 	 ofParameter<float> processingSize;
 	 ofParameter<bool> useROI;
+/**
+ * @brief The number of frames kept in the frame history, including the current one. 0 turns it off.
+ */
+	 ofParameter<int> historyDepth;
+/**
+ * @brief Whether the frame history also keeps the full resolution source frames.
+ */
+	 ofParameter<bool> historyIncludesSource;
 	 ofParameterGroup processesParameters;
 	 ofParameterGroup inputSourcesParameters;
 
 private:
 	 int inputWidth = 0;
 	 int inputHeight = 0;
+	 int inputType = CV_8UC1;
 	 int processingWidth = 0;
 	 int processingHeight = 0;
+	 uint64_t frameNumber = 0;
 
 public:
 	 std::vector<std::shared_ptr<MTVideoProcess>> videoProcesses;
@@ -91,6 +111,15 @@ public:
  * MTVideoProcess instances in the stream have completed.
  */
 	 ofFastEvent<MTVideoInputStreamCompleteEventArgs> streamCompleteFastEvent;
+/**
+ * @brief Listens to streamCompleteFastEvent on a thread of its own, so that a slow listener does not
+ * hold up the stream. The listener is called for as long as the returned object is alive.
+ * The stream reuses its buffers, so input and result are cloned before they are queued.
+ */
+	 std::shared_ptr<MTAsyncListener<MTVideoInputStreamCompleteEventArgs>>
+	 addAsyncListener(std::function<void(MTVideoInputStreamCompleteEventArgs&)> callback,
+					  size_t queueDepth = 2,
+					  MTAsyncDropPolicy policy = MTAsyncDropPolicy::DropOldest);
 	 ofEvent<std::shared_ptr<MTVideoProcess>> processAddedEvent;
 	 ofEvent<std::shared_ptr<MTVideoProcess>> processRemovedEvent;
 	 ofEvent<void> processOrderChangedEvent;
@@ -153,6 +182,13 @@ public:
 	 std::weak_ptr<MTVideoInputSource> getInputSource()
 	 { return inputSource; }
 
+/**
+ * @brief The recent frames of this stream. Only access it from the processing thread, i.e. from
+ * MTVideoProcess::process, where it is also available as MTProcessData::history.
+ */
+	 const MTFrameHistory& getFrameHistory() const
+	 { return frameHistory; }
+
 //////////////////////////////////
 //Utility
 //////////////////////////////////
@@ -199,6 +235,12 @@ public:
 
 	 void updateTransformInternals();
 
+/// Applies the mirror and flip to image, which then points to flipBuffer if it was flipped, and brings it to
+/// the processing size and ROI in working.
+	 void prepareImage(cv::Mat& image, cv::Mat& flipBuffer, cv::Mat& working);
+/// Everything prepareImage() does to the frame, the start of the process prefix cache keys.
+	 std::string getPreparationSignature();
+
 protected:
 //////////////////////////////////
 //Event Listeners
@@ -212,8 +254,16 @@ protected:
 	 bool isSetup;
 
 	 cv::Mat workingImage;
+	 MTVideoInputFrame currentFrame;
 	 cv::Mat videoInputImage;
+	 cv::Mat flippedImage;
+	 /// Color images of YUV frames, only filled when a process asks for color
+	 cv::Mat colorInputImage;
+	 cv::Mat colorFlippedImage;
+	 cv::Mat colorWorkingImage;
+	 std::shared_ptr<MTPointCloud> pointCloud;
 	 cv::Mat processOutput;
+	 MTFrameHistory frameHistory;
 
 //////////////////////////////////
 //Internals
@@ -256,6 +306,7 @@ struct MTProcessData
 	 cv::Mat processResult;
 /**
  * @brief The source pixels of the stream, i.e. the video pixels. You shouldn't modify this Mat.
+ * If the source delivers YUV, this is only the luma, see getColorSource().
  */
 	 cv::Mat processSource;
 /**
@@ -266,6 +317,43 @@ struct MTProcessData
  * @brief An unordered_map for any custom Mat's that you may want to use in your own processes.
  */
 	 std::unordered_map<std::string, cv::Mat> user;
+/**
+ * @brief The past frames of the stream, shared by all processes. history->getStream(1) is the
+ * processStream of the previous frame as it entered the first process. Null if the stream has no history.
+ * The Mats are shallow, don't modify them.
+ */
+	 const MTFrameHistory* history = nullptr;
+/**
+ * @brief The point cloud of the frame, if the input source produces one (i.e. RealSense in Output3D mode).
+ * Point cloud processes replace it with their own output, like processStream. Don't modify a cloud
+ * that you didn't create.
+ */
+	 std::shared_ptr<MTPointCloud> pointCloud;
+
+/**
+ * @brief Set by the stream, converts the current frame to color. See getColorStream().
+ */
+	 std::function<void(cv::Mat& source, cv::Mat& stream)> colorConverter;
+
+/**
+ * @brief The frame in color at the processing size, as it entered the first process. Sources that deliver
+ * YUV only put the luma in processStream, which is all that grayscale processes need. Processes that
+ * need color call this, and the frame is converted the first time it is called in a frame.
+ */
+	 const cv::Mat& getColorStream()
+	 {
+			convertColor();
+			return colorStream;
+	 }
+
+/**
+ * @brief processSource in color. See getColorStream().
+ */
+	 const cv::Mat& getColorSource()
+	 {
+			convertColor();
+			return colorSource;
+	 }
 
 	 void clear()
 	 {
@@ -274,6 +362,22 @@ struct MTProcessData
 			processResult = Mat();
 			processSource = Mat();
 			processMask = Mat();
+			pointCloud = nullptr;
+			colorSource = Mat();
+			colorStream = Mat();
+			isColorReady = false;
+	 }
+
+private:
+	 cv::Mat colorSource;
+	 cv::Mat colorStream;
+	 bool isColorReady = false;
+
+	 void convertColor()
+	 {
+			if (isColorReady) return;
+			isColorReady = true;
+			if (colorConverter) colorConverter(colorSource, colorStream);
 	 }
 };
 
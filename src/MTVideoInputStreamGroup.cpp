@@ -0,0 +1,129 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include "MTVideoInputStreamGroup.hpp"
+
+MTVideoInputStreamGroup::MTVideoInputStreamGroup(std::string name) : MTModel(name)
+{
+	parameters.add(tolerance.set("Tolerance", 20, 1, 200));
+}
+
+void MTVideoInputStreamGroup::addStream(std::shared_ptr<MTVideoInputStream> stream)
+{
+	auto member = std::make_shared<Member>();
+	member->stream = stream;
+	std::weak_ptr<Member> weakMember = member;
+	member->listener = stream->streamCompleteFastEvent.newListener(
+			[this, weakMember](MTVideoInputStreamCompleteEventArgs& args)
+			{
+				if (auto member = weakMember.lock()) push(*member, args);
+			});
+
+	std::lock_guard<std::mutex> lock(mutex);
+	members.push_back(member);
+}
+
+void MTVideoInputStreamGroup::removeStream(std::shared_ptr<MTVideoInputStream> stream)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	members.erase(std::remove_if(members.begin(), members.end(), [&stream](const std::shared_ptr<Member>& member)
+	{
+		auto s = member->stream.lock();
+		return s == nullptr || s == stream;
+	}), members.end());
+}
+
+void MTVideoInputStreamGroup::clear()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	members.clear();
+}
+
+size_t MTVideoInputStreamGroup::getStreamCount()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return members.size();
+}
+
+MTVideoInputStreamGroupStats MTVideoInputStreamGroup::getStats()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+void MTVideoInputStreamGroup::push(Member& member, const MTVideoInputStreamCompleteEventArgs& args)
+{
+	MTVideoInputStreamCompleteEventArgs frame;
+	frame.stream = args.stream;
+	// The stream reuses its buffers:
+	frame.result = args.result.clone();
+	frame.fps = args.fps;
+	frame.captureTime = args.captureTime;
+	frame.frameNumber = args.frameNumber;
+
+	MTVideoInputStreamBundle bundle;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		member.frames.push_back(std::move(frame));
+		if (member.frames.size() > MaxQueued)
+		{
+			member.frames.pop_front();
+			stats.droppedFrames++;
+		}
+		if (!match(bundle)) return;
+	}
+
+	// Outside of the lock, so that the other streams can keep pushing:
+	ofNotifyEvent(bundleFastEvent, bundle, this);
+}
+
+bool MTVideoInputStreamGroup::match(MTVideoInputStreamBundle& bundle)
+{
+	if (members.empty()) return false;
+	const auto window = uint64_t(tolerance.get() * 1000);
+
+	while (true)
+	{
+		// The bundle can't be older than the latest of the oldest frames:
+		uint64_t reference = 0;
+		for (const auto& member : members)
+		{
+			if (member->frames.empty()) return false;
+			reference = std::max(reference, member->frames.front().captureTime);
+		}
+
+		// Frames too far behind the reference will never be matched:
+		bool hasDropped = false;
+		for (auto& member : members)
+		{
+			while (!member->frames.empty() && member->frames.front().captureTime + window < reference)
+			{
+				member->frames.pop_front();
+				stats.droppedFrames++;
+				hasDropped = true;
+			}
+		}
+		// The next frames may be later than the reference, start over with them:
+		if (hasDropped) continue;
+
+		// Every stream has a frame within the window of the reference, and none after it:
+		uint64_t earliest = reference;
+		bundle.frames.clear();
+		for (auto& member : members)
+		{
+			earliest = std::min(earliest, member->frames.front().captureTime);
+			bundle.frames.push_back(std::move(member->frames.front()));
+			member->frames.pop_front();
+		}
+
+		bundle.skew = (reference - earliest) * 0.001f;
+		bundle.latency = (ofGetElapsedTimeMicros() - earliest) * 0.001f;
+		bundle.bundleNumber = ++stats.bundles;
+		stats.skew = bundle.skew;
+		stats.maxSkew = std::max(stats.maxSkew, bundle.skew);
+		stats.latency = bundle.latency;
+		stats.maxLatency = std::max(stats.maxLatency, bundle.latency);
+		return true;
+	}
+}
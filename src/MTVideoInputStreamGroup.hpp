@@ -0,0 +1,94 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTVIDEOINPUTSTREAMGROUP_HPP
+#define NERVOUSSTRUCTUREOF_MTVIDEOINPUTSTREAMGROUP_HPP
+
+#include <deque>
+#include "MTModel.hpp"
+#include "MTVideoInputStream.hpp"
+
+/**
+ * @brief The frames of the streams of a group that were captured at (about) the same time.
+ */
+struct MTVideoInputStreamBundle
+{
+	/**
+	 * @brief One entry per stream, in the order the streams were added to the group. result is a
+	 * copy that belongs to the bundle, input is not included.
+	 */
+	std::vector<MTVideoInputStreamCompleteEventArgs> frames;
+	/**
+	 * @brief The difference between the earliest and the latest capture time of the frames, in milliseconds.
+	 */
+	float skew;
+	/**
+	 * @brief Time from the earliest capture to the publication of the bundle, in milliseconds.
+	 */
+	float latency;
+	uint64_t bundleNumber;
+};
+
+struct MTVideoInputStreamGroupStats
+{
+	uint64_t bundles = 0;
+	/**
+	 * @brief Frames that could not be matched with the frames of the other streams.
+	 */
+	uint64_t droppedFrames = 0;
+	float skew = 0;
+	float maxSkew = 0;
+	float latency = 0;
+	float maxLatency = 0;
+};
+
+/**
+ * @brief Matches the results of several streams by capture time. A bundle is published when every stream
+ * has a frame within the tolerance of the others. Frames that are too old to ever be matched are dropped.
+ * Bundles are published from the thread of the stream that completed them.
+ */
+class MTVideoInputStreamGroup : public MTModel
+{
+public:
+	/**
+	 * @brief The largest difference in capture time allowed within a bundle, in milliseconds.
+	 */
+	ofParameter<float> tolerance;
+	ofFastEvent<MTVideoInputStreamBundle> bundleFastEvent;
+
+	MTVideoInputStreamGroup(std::string name);
+	void addStream(std::shared_ptr<MTVideoInputStream> stream);
+	void removeStream(std::shared_ptr<MTVideoInputStream> stream);
+	void clear();
+	size_t getStreamCount();
+
+	/**
+	 * @brief Thread-safe.
+	 */
+	MTVideoInputStreamGroupStats getStats();
+
+private:
+	struct Member
+	{
+		std::weak_ptr<MTVideoInputStream> stream;
+		ofEventListener listener;
+		std::deque<MTVideoInputStreamCompleteEventArgs> frames;
+	};
+
+	/// Frames kept per stream while waiting for the others
+	static const size_t MaxQueued = 4;
+
+	std::vector<std::shared_ptr<Member>> members;
+	std::mutex mutex;
+	MTVideoInputStreamGroupStats stats;
+
+	void push(Member& member, const MTVideoInputStreamCompleteEventArgs& args);
+	/**
+	 * @brief Must be called with mutex locked.
+	 * @return true if a bundle was formed.
+	 */
+	bool match(MTVideoInputStreamBundle& bundle);
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTVIDEOINPUTSTREAMGROUP_HPP
@@ -0,0 +1,126 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include "MTVideoPreview.hpp"
+
+uint64_t MTVideoPreviewMailbox::VisibleTimeout = 250;
+
+MTVideoPreviewMailbox::MTVideoPreviewMailbox()
+{
+	lastDrawTime.store(0);
+	targetWidth.store(0);
+	isQueued.store(false);
+}
+
+void MTVideoPreviewMailbox::post(MTSharedFrame frame)
+{
+	if (frame.empty() || !isVisible()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pending = std::move(frame);
+	}
+
+	// Only one trip through the worker's queue at a time, later frames just replace pending:
+	if (!isQueued.exchange(true))
+	{
+		MTVideoPreviewWorker::Instance().enqueue(shared_from_this());
+	}
+}
+
+void MTVideoPreviewMailbox::setVisible(int width)
+{
+	targetWidth.store(width);
+	lastDrawTime.store(ofGetElapsedTimeMillis());
+}
+
+bool MTVideoPreviewMailbox::isVisible() const
+{
+	return ofGetElapsedTimeMillis() - lastDrawTime.load() < VisibleTimeout;
+}
+
+bool MTVideoPreviewMailbox::receive(cv::Mat& image, cv::Size& sourceSize)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!hasReady) return false;
+	// Swapping hands the previous buffer back to the worker for reuse:
+	cv::swap(image, ready);
+	sourceSize = readySourceSize;
+	hasReady = false;
+	return true;
+}
+
+void MTVideoPreviewMailbox::resizePending()
+{
+	MTSharedFrame frame;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::swap(frame, pending);
+	}
+	isQueued.store(false);
+	if (frame.empty()) return;
+	const cv::Mat& image = frame.get();
+
+	int width = targetWidth.load();
+	if (width > 0 && image.cols > width)
+	{
+		int height = std::max(1, image.rows * width / image.cols);
+		cv::resize(image, working, cv::Size(width, height), 0, 0, cv::INTER_AREA);
+	}
+	else
+	{
+		// Still a copy, the process writes into its buffer again once the frame is let go of:
+		image.copyTo(working);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	cv::swap(working, ready);
+	readySourceSize = image.size();
+	hasReady = true;
+}
+
+MTVideoPreviewWorker::MTVideoPreviewWorker()
+{
+	setThreadName("MTVideoPreviewWorker");
+	startThread();
+}
+
+MTVideoPreviewWorker::~MTVideoPreviewWorker()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopThread();
+	}
+	condition.notify_all();
+	waitForThread(false);
+}
+
+void MTVideoPreviewWorker::enqueue(std::shared_ptr<MTVideoPreviewMailbox> mailbox)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queue.push_back(std::move(mailbox));
+	}
+	condition.notify_one();
+}
+
+void MTVideoPreviewWorker::threadedFunction()
+{
+	while (isThreadRunning())
+	{
+		std::shared_ptr<MTVideoPreviewMailbox> mailbox;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this]()
+			{
+				return !queue.empty() || !isThreadRunning();
+			});
+			if (queue.empty()) continue;
+			mailbox = std::move(queue.front());
+			queue.pop_front();
+		}
+
+		mailbox->resizePending();
+	}
+}
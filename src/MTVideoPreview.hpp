@@ -0,0 +1,98 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTVIDEOPREVIEW_HPP
+#define NERVOUSSTRUCTUREOF_MTVIDEOPREVIEW_HPP
+
+#include <deque>
+#include <condition_variable>
+#include <utils/ofThread.h>
+#include "ofxCv.h"
+#include "MTSharedFrame.hpp"
+
+/**
+ * @brief Holds the latest preview frame of a process. Frames are posted from the processing thread,
+ * downsized to the width of the panel by MTVideoPreviewWorker, and picked up by the UI.
+ * Older frames are overwritten, never queued, and nothing is posted while the preview is not being drawn.
+ */
+class MTVideoPreviewMailbox : public std::enable_shared_from_this<MTVideoPreviewMailbox>
+{
+public:
+	/**
+	 * @brief How long a preview counts as visible after it was last drawn.
+	 */
+	static uint64_t VisibleTimeout;
+
+	MTVideoPreviewMailbox();
+
+	/**
+	 * @brief Processing thread. Hands frame to the worker if the preview is visible. The frame keeps
+	 * the image from being written into until the worker has read it, it is not copied here.
+	 */
+	void post(MTSharedFrame frame);
+
+	/**
+	 * @brief UI thread. Marks the preview as visible for VisibleTimeout milliseconds.
+	 * @param width The widest the preview is going to be drawn, in pixels. Larger frames are downsized to it.
+	 */
+	void setVisible(int width);
+
+	bool isVisible() const;
+
+	/**
+	 * @brief UI thread. Swaps the latest downsized frame into image.
+	 * @param sourceSize The size of the frame before it was downsized.
+	 * @return false if there is no new frame since the last call.
+	 */
+	bool receive(cv::Mat& image, cv::Size& sourceSize);
+
+private:
+	friend class MTVideoPreviewWorker;
+
+	std::mutex mutex;
+	MTSharedFrame pending;
+	cv::Mat ready;
+	cv::Size readySourceSize;
+	bool hasReady = false;
+	/// Only touched by the worker
+	cv::Mat working;
+	std::atomic<uint64_t> lastDrawTime;
+	std::atomic_int targetWidth;
+	std::atomic_bool isQueued;
+
+	/**
+	 * @brief Worker thread. Downsizes the pending frame into ready.
+	 */
+	void resizePending();
+};
+
+/**
+ * @brief The thread that downsizes the frames of all the previews, so that the processing threads only pay
+ * for handing over a cv::Mat header.
+ */
+class MTVideoPreviewWorker : public ofThread
+{
+public:
+	static MTVideoPreviewWorker& Instance()
+	{
+		static MTVideoPreviewWorker instance;
+		return instance;
+	}
+
+	MTVideoPreviewWorker(MTVideoPreviewWorker const&) = delete;
+	void operator=(MTVideoPreviewWorker const&) = delete;
+
+	void enqueue(std::shared_ptr<MTVideoPreviewMailbox> mailbox);
+
+protected:
+	void threadedFunction() override;
+
+private:
+	MTVideoPreviewWorker();
+	~MTVideoPreviewWorker();
+	std::deque<std::shared_ptr<MTVideoPreviewMailbox>> queue;
+	std::condition_variable condition;
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTVIDEOPREVIEW_HPP
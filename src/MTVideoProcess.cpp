@@ -11,6 +11,12 @@ MTVideoProcess::MTVideoProcess(std::string name, std::string typeName) : MTModel
 	parameters.add(processTypeName, isActive);
 	processWidth = 320;
 	processHeight = 240;
+	registerOutputBuffer(processBuffer);
+	isSignatureStale.store(true);
+	addEventListener(parameters.parameterChangedE().newListener([this](ofAbstractParameter& parameter)
+																{
+																	isSignatureStale.store(true);
+																}));
 };
 
 MTVideoProcess::~MTVideoProcess()
@@ -23,7 +29,79 @@ void MTVideoProcess::setup()
 	processOutput.create(processHeight, processWidth, CV_8UC1);
 }
 
+const std::string& MTVideoProcess::getSignature()
+{
+	if (isSignatureStale.exchange(false))
+	{
+		std::stringstream stream;
+		stream << processTypeName.get() << " " << parameters;
+		signature = stream.str();
+	}
+	return signature;
+}
+
 std::shared_ptr<MTVideoProcessUI> MTVideoProcess::createUI()
 {
 	return std::make_shared<MTVideoProcessUI>(shared_from_this());
 }
+
+MTSharedFrame MTVideoProcess::shareOutput()
+{
+	if (processOutput.u != nullptr)
+	{
+		// Shared more than once in a frame, i.e. by the event and by the preview. One lease covers all:
+		auto existing = outputLease.lock();
+		if (existing != nullptr && leasedData == processOutput.u) return MTSharedFrame(processOutput, existing);
+
+		for (auto buffer : outputBuffers)
+		{
+			if (buffer->u != processOutput.u) continue;
+			// The lease tells us whether anyone still holds the frame by the next time around:
+			auto lease = std::make_shared<char>(0);
+			outputLease = lease;
+			leasedData = processOutput.u;
+			return MTSharedFrame(processOutput, lease);
+		}
+	}
+
+	// The output lives in a buffer the process keeps writing to (i.e. a running state), copy it:
+	return MTSharedFrame(processOutput.clone());
+}
+
+cv::Mat MTVideoProcess::to8Bit(const cv::Mat& input, cv::Mat& buffer)
+{
+	if (input.depth() != CV_16U) return input;
+	if (!hasWarned16Bit)
+	{
+		ofLogWarning(processTypeName.get()) << "Only works on 8-bit images, 16-bit input is scaled down to 8 bits";
+		hasWarned16Bit = true;
+	}
+	input.convertTo(buffer, CV_8U, 1.0 / 257.0);
+	return buffer;
+}
+
+void MTVideoProcess::recycleBuffers()
+{
+	// Don't write the next frame into another stream's result:
+	if (isOutputCached)
+	{
+		processOutput.release();
+		isOutputCached = false;
+	}
+
+	if (leasedData == nullptr) return;
+
+	if (!outputLease.expired())
+	{
+		// Take the buffer out of the process. The frame keeps the data alive, and the process
+		// allocates a new buffer the next time it creates one:
+		for (auto buffer : outputBuffers)
+		{
+			if (buffer->u == leasedData) buffer->release();
+		}
+		if (processOutput.u == leasedData) processOutput.release();
+	}
+
+	outputLease.reset();
+	leasedData = nullptr;
+}
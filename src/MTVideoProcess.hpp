@@ -13,6 +13,8 @@
 #include "MTModel.hpp"
 #include "ofxCv.h"
 #include "registry.h"
+#include "MTSharedFrame.hpp"
+#include "MTAsyncListener.hpp"
 
 class MTVideoInputStream;
 class MTProcessData;
@@ -21,21 +23,28 @@ class MTVideoProcessUI;
 
 
 /**
- * @brief ProcessCompleteEventArgs clone (deep copy) the output of the process, making it "thread-safer".
+ * @brief ProcessCompleteEventArgs hand out the output of the process as an MTSharedFrame, which stays
+ * valid after the process moves on to the next frame, making it "thread-safer".
  * If you need to use the output of the process on a different timeline than that of
- * the ProcessChain, use this event.
+ * the ProcessChain, use this event and keep a copy of frame. Nothing is cloned unless
+ * the process cannot give up its output buffer, or you call frame.makeMutable().
  * @tparam T The process type
  */
 template<typename T>
 class MTVideoProcessCompleteEventArgs : public ofEventArgs
 {  //TODO: ProcessEventArgs vs. ProcessFastEventArgs!
 public:
+	MTSharedFrame frame;
+	/**
+	 * @brief Same data as frame, read-only.
+	 */
 	cv::Mat processOutput;
 	T* process;
 
-	MTVideoProcessCompleteEventArgs(cv::Mat& processOutput, T* process)
+	MTVideoProcessCompleteEventArgs(MTSharedFrame frame, T* process)
 	{
-		this->processOutput = processOutput.clone();
+		this->frame = std::move(frame);
+		this->processOutput = this->frame.get();
 		this->process = process;
 	}
 };
@@ -115,12 +124,73 @@ public:
 		// Only create the ProcessEventArgs if there is someone listening:
 		if (processCompleteEvent.size() > 0)
 		{
-			auto processEventArgs = MTVideoProcessCompleteEventArgs<MTVideoProcess>(processOutput, this);
+			auto processEventArgs = MTVideoProcessCompleteEventArgs<MTVideoProcess>(shareOutput(), this);
 			ofNotifyEvent(processCompleteEvent, processEventArgs, this);
 		}
 
 	}
 
+	/**
+	 * @brief Whether the output depends only on the input of the current frame and the parameters.
+	 * Streams that share a source only run a stateless process once per frame when they have it,
+	 * with the same settings, at the same position at the start of their chain.
+	 * Processes that keep anything from one frame to the next must return false (the default).
+	 */
+	virtual bool isStateless()
+	{ return false; }
+
+	/**
+	 * @brief Whether the process works on processStream. Sources in point cloud mode don't deliver
+	 * an image, and the stream skips these processes until one that doesn't need an image has made one
+	 * (i.e. a height map).
+	 */
+	virtual bool needsImage()
+	{ return true; }
+
+	/**
+	 * @brief The type name and the values of all the parameters. Two processes with the same signature
+	 * produce the same output from the same input, if they are stateless.
+	 */
+	const std::string& getSignature();
+
+	/**
+	 * @brief Listens to processCompleteEvent on a thread of its own, so that a slow listener does not
+	 * hold up the stream. The listener is called for as long as the returned object is alive.
+	 */
+	std::shared_ptr<MTAsyncListener<MTVideoProcessCompleteEventArgs<MTVideoProcess>>>
+	addAsyncListener(std::function<void(MTVideoProcessCompleteEventArgs<MTVideoProcess>&)> callback,
+					 size_t queueDepth = 2,
+					 MTAsyncDropPolicy policy = MTAsyncDropPolicy::DropOldest)
+	{
+		auto listener = std::make_shared<MTAsyncListener<MTVideoProcessCompleteEventArgs<MTVideoProcess>>>(
+				std::move(callback), queueDepth, policy);
+		listener->subscribe(processCompleteEvent);
+		return listener;
+	}
+
+	/**
+	 * @brief Called by the stream before process(). Lets go of the output buffer if a shared frame
+	 * of it is still alive, so that the process writes the next frame into a new buffer.
+	 */
+	void recycleBuffers();
+
+	/**
+	 * @brief Called by the stream instead of process() when another stream already ran this process on
+	 * the frame. output is shared with the other streams, it is let go of in recycleBuffers().
+	 */
+	void setCachedOutput(const cv::Mat& output)
+	{
+		processOutput = output;
+		isOutputCached = true;
+	}
+
+	/**
+	 * @brief processOutput as an MTSharedFrame. Shared without a copy if it lives in one of the
+	 * output buffers, cloned otherwise. The process does not write into a shared buffer again for as
+	 * long as the frame is held. Only call it from the processing thread, i.e. in a fast event listener.
+	 */
+	MTSharedFrame shareOutput();
+
 protected:
 	cv::Mat processBuffer;
 	cv::Mat processOutput;
@@ -129,6 +199,30 @@ protected:
 	ofRectangle outputTarget;
 	bool markProcessSizeChanged = false;
 
+	/**
+	 * @brief Makes an output buffer other than processBuffer eligible to be shared without a copy.
+	 * Only register buffers that the process (re)creates before writing into them, as they are released
+	 * while a shared frame of them is alive. Processes that write straight into processOutput register it
+	 * here, but only if processOutput is never assigned a buffer that is kept from frame to frame.
+	 */
+	void registerOutputBuffer(cv::Mat& buffer)
+	{ outputBuffers.push_back(&buffer); }
+
+	/**
+	 * @brief For processes that only work on 8-bit images. 16-bit input (i.e. depth) is scaled down to
+	 * 8 bits into buffer, with a warning the first time. Other input is returned as it is.
+	 */
+	cv::Mat to8Bit(const cv::Mat& input, cv::Mat& buffer);
+
+private:
+	std::string signature;
+	std::atomic_bool isSignatureStale;
+	std::vector<cv::Mat*> outputBuffers;
+	std::weak_ptr<void> outputLease;
+	cv::UMatData* leasedData = nullptr;
+	bool isOutputCached = false;
+	bool hasWarned16Bit = false;
+
 };
 
 
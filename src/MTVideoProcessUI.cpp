@@ -29,18 +29,21 @@ MTVideoProcessUIWithImage::
 MTVideoProcessUIWithImage(std::shared_ptr<MTVideoProcess> videoProcess,
 						  ofImageType imageType) : MTVideoProcessUI(videoProcess)
 {
-	auto stream = videoProcess->processStream.lock();
+	preview = std::make_shared<MTVideoPreviewMailbox>();
 	addEventListener(videoProcess->processCompleteFastEvent.newListener([this](
 			const MTVideoProcessCompleteFastEventArgs<MTVideoProcess>& args)
 																		{
-																			outputChannel.send(args.processOutput);
+																			// Frozen until the worker has read it. Not shared
+																			// (or cloned) while nobody is looking:
+																			if (preview->isVisible())
+																			{
+																				preview->post(args.process->shareOutput());
+																			}
 																		}));
 }
 
 MTVideoProcessUIWithImage::~MTVideoProcessUIWithImage()
-{
-	outputChannel.close();
-}
+{}
 
 void MTVideoProcessUIWithImage::draw(ofxImGui::Settings& settings)
 {
@@ -54,33 +57,34 @@ void MTVideoProcessUIWithImage::draw(ofxImGui::Settings& settings)
 
 void MTVideoProcessUIWithImage::drawImage()
 {
-	ofAbstractHasPixels pixels;
-	cv::Mat cvImage;
-	while (outputChannel.tryReceive(cvImage))
+	auto available = ImGui::GetContentRegionAvailWidth();
+	preview->setVisible((int) available);
+
+	// At most one upload per UI frame, of the latest output only:
+	if (preview->receive(previewImage, previewSourceSize))
 	{
-		auto depth = cvImage.depth();
+		auto depth = previewImage.depth();
 		if (depth == CV_16U)
 		{
-			loadTextureData<unsigned short>(cvImage);
+			loadTextureData<unsigned short>(previewImage);
 		}
 		else if (depth == CV_32F ||
 				 depth == CV_64F /*|| depth == CV_16F*/)
 		{
-			loadTextureData<float>(cvImage);
+			loadTextureData<float>(previewImage);
 		}
 		else
 		{
-			loadTextureData<unsigned char>(cvImage);
+			loadTextureData<unsigned char>(previewImage);
 		}
-
 	}
 
 	if (outputImage.isAllocated())
 	{
-		auto ow = outputImage.getWidth() * ImageScale;
-		auto w = std::min(ow, ImGui::GetContentRegionAvailWidth());
+		auto ow = previewSourceSize.width * ImageScale;
+		auto w = std::min(ow, available);
 		auto ratio = w / ow;
-		auto h = outputImage.getHeight() * ImageScale * ratio;
+		auto h = previewSourceSize.height * ImageScale * ratio;
 		ofxImGui::AddImage(outputImage, glm::vec2(w, h));
 	}
 }
@@ -9,6 +9,7 @@
 #include "ofxImGui.h"
 #include "MTAppFrameworkUtils.hpp"
 #include "ofxCv.h"
+#include "MTVideoPreview.hpp"
 
 class MTVideoProcess;
 
@@ -47,6 +48,10 @@ public:
 	 * @param settings
 	 */
 	void draw(ofxImGui::Settings& settings) override;
+	/**
+	 * @brief Draws the latest output, downsized to the available width. Outputs are only
+	 * forwarded to the preview while this keeps getting called.
+	 */
 	void drawImage();
 	int outputImageWidth = 320;
 	int outputImageHeight = 240;
@@ -56,7 +61,10 @@ public:
 	static float ImageScale;
 
 protected:
-	ofThreadChannel<cv::Mat> outputChannel;
+	std::shared_ptr<MTVideoPreviewMailbox> preview;
+	cv::Mat previewImage;
+	/// The size of the output before it was downsized, for the aspect ratio and ImageScale
+	cv::Size previewSourceSize;
 private:
 
 	template<class T>
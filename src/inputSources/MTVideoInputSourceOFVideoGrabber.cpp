@@ -7,16 +7,42 @@
 
 
 MTVideoInputSourceOFGrabber::MTVideoInputSourceOFGrabber(std::string devID) :
-		MTVideoInputSource("ofVideoGrabber", "MTVideoInputSourceOFGrabber", "ofVideoGrabber", devID){}
+		MTVideoInputSource("ofVideoGrabber", "MTVideoInputSourceOFGrabber", "ofVideoGrabber", devID)
+{
+	addParameters(capturePolicy.set("Capture Policy", MTVideoCaptureThread::Latest,
+									MTVideoCaptureThread::Latest, MTVideoCaptureThread::FIFO),
+				  nativeYUV.set("Native YUV", false));
+	addEventListener(capturePolicy.newListener([this](int& val)
+											   {
+												   setup();
+											   }));
+	addEventListener(nativeYUV.newListener([this](bool& val)
+										   {
+											   setup();
+										   }));
+}
+
+MTVideoInputSourceOFGrabber::~MTVideoInputSourceOFGrabber()
+{
+	// The capture thread must be done with the grabber before it goes away:
+	MTVideoInputSourceOFGrabber::close();
+}
 
 bool MTVideoInputSourceOFGrabber::isFrameNew()
 {
-	return grabber.isFrameNew();
+	bool isNew = isNewFrame;
+	isNewFrame = false;
+	return isNew;
 }
 
 ofPixels& MTVideoInputSourceOFGrabber::getPixels()
 {
-	return grabber.getPixels();
+	return pixels;
+}
+
+MTVideoInputFrame MTVideoInputSourceOFGrabber::getFrame()
+{
+	return frame;
 }
 
 void MTVideoInputSourceOFGrabber::start()
@@ -26,14 +52,27 @@ void MTVideoInputSourceOFGrabber::start()
 
 void MTVideoInputSourceOFGrabber::close()
 {
+	captureThread.stop();
+	frame = MTVideoInputFrame();
+	pixels.clear();
+	isNewFrame = false;
 	grabber.close();
 }
 
 void MTVideoInputSourceOFGrabber::update()
 {
-	grabber.update();
-	if (grabber.isFrameNew())
+	// Capture happens in the capture thread, this only picks up what it has:
+	if (captureThread.receive(frame))
 	{
+		if (captureFormat != MTVideoInputFrame::Packed)
+		{
+			// The stream may still hold the last luma:
+			if (lumaBuffer.u != nullptr && lumaBuffer.u->refcount > 1) lumaBuffer.release();
+			frame.setYUV(frame.image, captureFormat, lumaBuffer);
+		}
+		const auto& image = frame.image;
+		pixels.setFromExternalPixels(image.data, image.cols, image.rows, image.channels());
+		isNewFrame = true;
 //		MTCaptureEventArgs args;
 //		args.inputSource = this->shared_from_this();
 //		args.frame = grabber.getPixels();
@@ -50,12 +89,62 @@ void MTVideoInputSourceOFGrabber::setup()
 
 void MTVideoInputSourceOFGrabber::setup(int width, int height, int framerate, std::string deviceID)
 {
+	captureThread.stop();
 	grabber.close();
 	grabber.setDeviceID(ofFromString<int>(deviceID));
 	grabber.setDesiredFrameRate(framerate);
-	grabber.setup(width, height, false);
+	// The grabber only knows which formats the backend takes once it is set up, so each YUV format is
+	// tried in turn and checked against what was actually resolved, before falling back to RGB:
+	std::vector<ofPixelFormat> formats;
+	if (nativeYUV) formats = {OF_PIXELS_NV12, OF_PIXELS_YUY2};
+	formats.push_back(OF_PIXELS_RGB);
+	for (auto format : formats)
+	{
+		grabber.close();
+		grabber.setPixelFormat(format);
+		if (grabber.setup(width, height, false) && grabber.getPixelFormat() == format) break;
+	}
+
+	switch (grabber.getPixelFormat())
+	{
+		case OF_PIXELS_NV12:
+			captureFormat = MTVideoInputFrame::NV12;
+			break;
+		case OF_PIXELS_YUY2:
+			captureFormat = MTVideoInputFrame::YUYV;
+			break;
+		default:
+			if (nativeYUV) ofLogWarning("MTVideoInputSourceOFGrabber") << "The grabber can't deliver YUV, using RGB";
+			captureFormat = MTVideoInputFrame::Packed;
+			break;
+	}
+
 	// Get the width and height that the grabber actually resolved:
 	captureSize.setWithoutEventNotifications(glm::ivec2(grabber.getWidth(), grabber.getHeight()));
 	frameRate.setWithoutEventNotifications(framerate);
 	this->deviceID.setWithoutEventNotifications(deviceID);
+
+	// The grabber reuses its pixels, so each frame is copied once into the ring. YUV frames are copied
+	// as they are and split into planes in update():
+	captureThread.start([this](cv::Mat& image)
+						{
+							grabber.update();
+							if (!grabber.isFrameNew()) return false;
+							const auto& grabbed = grabber.getPixels();
+							int w = (int) grabbed.getWidth();
+							int h = (int) grabbed.getHeight();
+							switch (captureFormat)
+							{
+								case MTVideoInputFrame::NV12:
+									cv::Mat(h * 3 / 2, w, CV_8UC1, (void*) grabbed.getData()).copyTo(image);
+									break;
+								case MTVideoInputFrame::YUYV:
+									cv::Mat(h, w, CV_8UC2, (void*) grabbed.getData()).copyTo(image);
+									break;
+								default:
+									ofxCv::toCv(grabbed).copyTo(image);
+									break;
+							}
+							return true;
+						}, 3, (MTVideoCaptureThread::Policy) capturePolicy.get());
 }
@@ -6,21 +6,50 @@
 #define NERVOUSSTRUCTUREOF_MTVIDEOINPUTSOURCEOFVIDEOGRABBER_HPP
 
 #include "MTVideoInputSource.hpp"
+#include "MTVideoCaptureThread.hpp"
 
 class MTVideoInputSourceOFGrabber : public MTVideoInputSource
 {
 public:
+	/**
+	 * @brief See MTVideoCaptureThread::Policy.
+	 */
+	ofParameter<int> capturePolicy;
+	/**
+	 * @brief Asks the grabber for NV12 or YUYV instead of RGB, and hands the stream the luma without a color
+	 * conversion. Color is only converted if a process asks for it. Falls back to RGB if the backend can't.
+	 */
+	ofParameter<bool> nativeYUV;
+
 	MTVideoInputSourceOFGrabber(std::string devID);
+	~MTVideoInputSourceOFGrabber();
 	bool isFrameNew() override;
 	ofPixels& getPixels() override;
+	/**
+	 * @brief The frame as it came out of the capture ring, without a copy.
+	 */
+	MTVideoInputFrame getFrame() override;
 	void start() override;
 	void close() override;
 	void update() override;
 	void setup() override;
 	void setup(int width, int height, int framerate, std::string deviceID) override;
 
+	MTVideoCaptureThread::Stats getCaptureStats()
+	{ return captureThread.getStats(); }
+
 private:
 	ofVideoGrabber grabber;
+	/// Grabs on its own thread, the grabber is only touched by it while it runs
+	MTVideoCaptureThread captureThread;
+	MTVideoInputFrame frame;
+	/// Points to the pixels of frame
+	ofPixels pixels;
+	bool isNewFrame = false;
+	/// The format of the frames in the ring, decided in setup()
+	MTVideoInputFrame::Format captureFormat = MTVideoInputFrame::Packed;
+	/// The luma of YUYV frames
+	cv::Mat lumaBuffer;
 };
 
 
@@ -3,6 +3,7 @@
 //
 
 #include "MTVideoInputSourceRealSense.hpp"
+#include <chrono>
 
 #ifdef MTVI_USE_REALSENSE
 
@@ -26,6 +27,16 @@ MTVideoInputSourceRealSense::MTVideoInputSourceRealSense(std::string devID) :
 		return;
 	}
 
+	initDevice();
+}
+
+MTVideoInputSourceRealSense::MTVideoInputSourceRealSense(std::string name, std::string typeName,
+														 std::string friendlyTypeName, std::string devID) :
+		MTVideoInputSource(name, typeName, friendlyTypeName, devID)
+{}
+
+void MTVideoInputSourceRealSense::initDevice()
+{
 	auto sensors = device.query_sensors();
 	for (auto s : sensors)
 	{
@@ -85,7 +96,8 @@ MTVideoInputSourceRealSense::MTVideoInputSourceRealSense(std::string devID) :
 						tempFilterDelta.set("Delta", 20, 1, 100)
 	);
 
-	addParameters(useColorizer.set("Enable Colorizer", true),
+	addParameters(outputMode.set("Output Mode", Output2D, Output2D, OutputRS2),
+				  useColorizer.set("Enable Colorizer", true),
 				  colorizerGroup,
 				  enableDepth.set("Enable Depth", true),
 				  enableColor.set("Enable Color", false),
@@ -134,9 +146,76 @@ bool MTVideoInputSourceRealSense::isFrameNew()
 
 const ofPixels& MTVideoInputSourceRealSense::getPixels()
 {
+	if (pixelsAreStale && !isDepthFrame)
+	{
+		auto vf = videoFrame.as<rs2::video_frame>();
+		toOf(vf, pixels);
+		pixelsAreStale = false;
+	}
 	return pixels;
 }
 
+bool MTVideoInputSourceRealSense::isShortPixels()
+{
+	return isDepthFrame;
+}
+
+const ofShortPixels& MTVideoInputSourceRealSense::getShortPixels()
+{
+	if (pixelsAreStale && isDepthFrame)
+	{
+		auto vf = videoFrame.as<rs2::video_frame>();
+		toOf<unsigned short>(vf, depthPixels, 1);
+		pixelsAreStale = false;
+	}
+	return depthPixels;
+}
+
+MTVideoInputFrame MTVideoInputSourceRealSense::getFrame()
+{
+	// Point clouds have no image:
+	if (outputMode == Output3D) return MTVideoInputFrame();
+
+	if (outputMode != Output2D || !videoFrame)
+	{
+		return MTVideoInputSource::getFrame();
+	}
+
+	auto vf = videoFrame.as<rs2::video_frame>();
+	int type;
+	switch (vf.get_bytes_per_pixel())
+	{
+		case 1:
+			type = CV_8UC1;
+			break;
+		case 2:
+			type = CV_16UC1;
+			break;
+		case 4:
+			type = CV_8UC4;
+			break;
+		default:
+			type = CV_8UC3;
+			break;
+	}
+
+	MTVideoInputFrame frame;
+	frame.image = cv::Mat(vf.get_height(), vf.get_width(), type,
+						  const_cast<void*>(vf.get_data()), (size_t) vf.get_stride_in_bytes());
+	// rs2::frame is refcounted by librealsense, this copy keeps the buffer out of the frame pool:
+	frame.owner = std::make_shared<rs2::frame>(videoFrame);
+	frame.captureTime = captureTime;
+	return frame;
+}
+
+bool MTVideoInputSourceRealSense::getPointCloud(MTPointCloud& cloud)
+{
+	if (outputMode != Output3D || !points) return false;
+	static_assert(sizeof(rs2::vertex) == 3 * sizeof(float), "rs2::vertex is expected to be 3 packed floats");
+	cloud.assignInterleaved(reinterpret_cast<const float*>(points.get_vertices()), points.size());
+	return true;
+}
+
 const rs2::points& MTVideoInputSourceRealSense::getPoints()
 {
 	return points;
@@ -242,6 +321,8 @@ void MTVideoInputSourceRealSense::close()
 		ofLogVerbose("MTVideoInputSourceRealSense") << "Stopping capture thread";
 		waitForThread();
 		isFrameAvailable = false;
+		videoFrame = rs2::frame();
+		pixelsAreStale = false;
 		sensor.stop();
 		sensor.close();
 		sleep(100);
@@ -260,10 +341,27 @@ void MTVideoInputSourceRealSense::update()
 	if (outputQueue.poll_for_frame(&frame))
 	{
 		rs2Frame = frame;
+		captureTime = ofGetElapsedTimeMicros();
+		// System and global timestamps are in milliseconds of the system clock. Move the frame back
+		// by its age. Hardware clock timestamps, and the recording times of bag files, can't be compared:
+		auto domain = frame.get_frame_timestamp_domain();
+		if (domain == RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME || domain == RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME)
+		{
+			double now = std::chrono::duration<double, std::milli>(
+					std::chrono::system_clock::now().time_since_epoch()).count();
+			double age = now - frame.get_timestamp();
+			if (age >= 0 && age < 1000 && age * 1000 < captureTime)
+			{
+				captureTime -= (uint64_t) (age * 1000);
+			}
+		}
 		if (outputMode == Output2D)
 		{
-			auto vf = frame.as<rs2::video_frame>();
-			toOf(vf, pixels);
+			// Without the colorizer the frame is the raw 16-bit depth, pass it along as is:
+			isDepthFrame = frame.get_profile().format() == RS2_FORMAT_Z16;
+			// Nothing is copied here, see getFrame():
+			videoFrame = frame;
+			pixelsAreStale = true;
 		}
 		else if (outputMode == Output3D)
 		{
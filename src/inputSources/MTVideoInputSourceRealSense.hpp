@@ -39,6 +39,17 @@ public:
 	~MTVideoInputSourceRealSense();
 	bool isFrameNew() override;
 	const ofPixels& getPixels() override;
+	bool isShortPixels() override;
+	const ofShortPixels& getShortPixels() override;
+	/**
+	 * @brief In Output2D mode, a header over the rs2::frame's own buffer. The frame is kept
+	 * alive by the returned MTVideoInputFrame, so nothing is copied.
+	 */
+	MTVideoInputFrame getFrame() override;
+	/**
+	 * @brief In Output3D mode, the vertices of the current rs2::points, without the points that have no depth.
+	 */
+	bool getPointCloud(MTPointCloud& cloud) override;
 	void start() override;
 	void close() override;
 	void update() override;
@@ -94,7 +105,17 @@ public:
 	std::vector<rs2::video_stream_profile> getStreamProfiles();
 	const rs2::depth_sensor getDepthSensor() { return sensor.as<rs2::depth_sensor>(); }
 
-private:
+protected:
+	/**
+	 * @brief For subclasses that provide their own rs2::device. They must set device and then call initDevice().
+	 */
+	MTVideoInputSourceRealSense(std::string name, std::string typeName, std::string friendlyTypeName,
+								std::string deviceID);
+	/**
+	 * @brief Finds the depth sensor of device and creates the parameters for its options and for the filters.
+	 */
+	void initDevice();
+
 	rs2::colorizer colorizer;
 	rs2::frame_queue outputQueue;
 	rs2::frame_queue postProcessingQueue;
@@ -112,6 +133,12 @@ private:
 	std::vector<rs2::filter> filters;
 	bool isFrameAvailable = false;
 	ofPixels pixels;
+	/// Raw Z16 depth, used in Output2D mode when the colorizer is off
+	ofShortPixels depthPixels;
+	bool isDepthFrame = false;
+	/// The current Output2D frame. pixels/depthPixels are only filled from it when someone asks for them.
+	rs2::frame videoFrame;
+	bool pixelsAreStale = false;
 	rs2::points points;
 	rs2::frame rs2Frame;
 	void setFilterOptions();
@@ -119,8 +146,14 @@ private:
 	ofMesh mesh;
 
 	template<typename T = unsigned char>
-	void toOf(rs2::video_frame& frame, ofPixels_<T>& pix)
+	void toOf(rs2::video_frame& frame, ofPixels_<T>& pix, size_t channels = 3)
 	{
+		// Filters like decimation change the size of the frame:
+		if (pix.getWidth() != frame.get_width() || pix.getHeight() != frame.get_height() ||
+			pix.getNumChannels() != channels)
+		{
+			pix.allocate(frame.get_width(), frame.get_height(), channels);
+		}
 		memcpy(pix.getData(), (T*) frame.get_data(),
 			   frame.get_width() * frame.get_height() * sizeof(T) * pix.getNumChannels());
 	}
@@ -0,0 +1,141 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include "MTVideoInputSourceRealSenseBag.hpp"
+
+#ifdef MTVI_USE_REALSENSE
+
+std::string MTVideoInputSourceRealSenseBag::SearchPath = "";
+
+MTVideoInputSourceRealSenseBag::MTVideoInputSourceRealSenseBag(std::string path) :
+		MTVideoInputSourceRealSense("RealSense Recording", "MTVideoInputSourceRealSenseBag",
+									"RealSense Recording", path)
+{
+	restartPending.store(false);
+	try
+	{
+		device = getRS2Context().load_device(ofToDataPath(path, true));
+		playback = device.as<rs2::playback>();
+		loadedPath = path;
+	}
+	catch (const rs2::error& e)
+	{
+		ofLogError("MTVideoInputSourceRealSenseBag") << "Could not load " << path << ": " << e.what();
+		isSetupFlag = false;
+		return;
+	}
+
+	initDevice();
+
+	addParameters(realTime.set("Real Time", true),
+				  loop.set("Loop", true));
+
+	playback.set_real_time(realTime);
+	addEventListener(realTime.newListener([this](bool& val)
+										  {
+											  playback.set_real_time(val);
+										  }));
+
+	// Called from the playback thread:
+	playback.set_status_changed_callback([this](rs2_playback_status status)
+										 {
+											 if (status == RS2_PLAYBACK_STATUS_STOPPED && loop &&
+												 isThreadRunning())
+											 {
+												 restartPending.store(true);
+											 }
+										 });
+
+	this->setThreadName("MTVideoInputSourceRealSenseBag");
+}
+
+MTVideoInputSourceRealSenseBag::~MTVideoInputSourceRealSenseBag()
+{
+	MTVideoInputSourceRealSenseBag::close();
+	if (!loadedPath.empty())
+	{
+		try
+		{
+			getRS2Context().unload_device(ofToDataPath(loadedPath, true));
+		}
+		catch (const rs2::error& e)
+		{
+			ofLogError("MTVideoInputSourceRealSenseBag") << e.what();
+		}
+	}
+}
+
+void MTVideoInputSourceRealSenseBag::start()
+{
+	if (isThreadRunning()) return;
+
+	sensor.start([this](rs2::frame frame)
+				 {
+					 // Without real time the playback runs as fast as this callback returns. Wait for the
+					 // filter thread instead of letting the queue drop frames:
+					 while (!realTime && postProcessingQueue.size() >= postProcessingQueue.capacity() &&
+							isThreadRunning())
+					 {
+						 std::this_thread::yield();
+					 }
+					 postProcessingQueue.enqueue(std::move(frame));
+				 });
+	startThread();
+}
+
+void MTVideoInputSourceRealSenseBag::close()
+{
+	if (!isThreadRunning()) return;
+
+	waitForThread();
+	isFrameAvailable = false;
+	videoFrame = rs2::frame();
+	pixelsAreStale = false;
+	// The playback stops its sensors by itself at the end of the file:
+	try
+	{
+		sensor.stop();
+	}
+	catch (const rs2::error& e)
+	{}
+	try
+	{
+		sensor.close();
+	}
+	catch (const rs2::error& e)
+	{}
+	rs2::frame frame;
+	while (postProcessingQueue.poll_for_frame(&frame))
+	{}
+	while (outputQueue.poll_for_frame(&frame))
+	{}
+}
+
+void MTVideoInputSourceRealSenseBag::update()
+{
+	if (restartPending.exchange(false))
+	{
+		ofLogVerbose("MTVideoInputSourceRealSenseBag") << "Looping " << loadedPath;
+		setup();
+	}
+
+	MTVideoInputSourceRealSense::update();
+}
+
+std::vector<std::string> MTVideoInputSourceRealSenseBag::ListRecordings()
+{
+	std::vector<std::string> recordings;
+	ofDirectory dir(SearchPath);
+	if (!dir.exists()) return recordings;
+	dir.allowExt("bag");
+	dir.listDir();
+	dir.sort();
+	for (const auto& file : dir)
+	{
+		recordings.push_back(file.path());
+	}
+	return recordings;
+}
+
+#endif
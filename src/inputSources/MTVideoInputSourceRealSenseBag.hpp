@@ -0,0 +1,49 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTVIDEOINPUTSOURCEREALSENSEBAG_HPP
+#define NERVOUSSTRUCTUREOF_MTVIDEOINPUTSOURCEREALSENSEBAG_HPP
+
+#include "MTVideoInputSourceRealSense.hpp"
+
+#ifdef MTVI_USE_REALSENSE
+
+/**
+ * @brief Replays a RealSense recording (.bag) through the same filter pipeline as a live camera,
+ * so that the depth filters and the processes downstream can be run without a device.
+ * The device ID is the path to the file.
+ */
+class MTVideoInputSourceRealSenseBag : public MTVideoInputSourceRealSense
+{
+public:
+	/**
+	 * @brief Plays the recording at its recorded rate. When off, frames are delivered as fast as the
+	 * filter thread can take them, and none are dropped on the way in.
+	 */
+	ofParameter<bool> realTime;
+	ofParameter<bool> loop;
+
+	/**
+	 * @brief Where the input sources provider looks for .bag files. Relative paths are relative to the data folder.
+	 */
+	static std::string SearchPath;
+
+	MTVideoInputSourceRealSenseBag(std::string path);
+	~MTVideoInputSourceRealSenseBag();
+	void start() override;
+	void close() override;
+	void update() override;
+
+	static std::vector<std::string> ListRecordings();
+
+protected:
+	rs2::playback playback;
+	std::string loadedPath;
+	/// Set by the playback thread when the end of the file is reached
+	std::atomic_bool restartPending;
+};
+
+#endif
+
+#endif //NERVOUSSTRUCTUREOF_MTVIDEOINPUTSOURCEREALSENSEBAG_HPP
@@ -0,0 +1,205 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include "MTVideoInputSourceTestPattern.hpp"
+
+const std::vector<std::string> MTVideoInputSourceTestPattern::PatternNames = {"Blobs",
+																			  "Noise",
+																			  "Lighting Ramp",
+																			  "Scene"};
+
+MTVideoInputSourceTestPattern::MTVideoInputSourceTestPattern(std::string pattern) :
+		MTVideoInputSource("Test Pattern", "MTVideoInputSourceTestPattern", "Test Pattern", pattern)
+{
+	addParameters(seed.set("Seed", 1, 0, 100000),
+				  cycleLength.set("Cycle Length", 120, 1, 600),
+				  blobCount.set("Blob Count", 6, 0, 32),
+				  noiseLevel.set("Noise Level", 8, 0, 64),
+				  paced.set("Paced", true));
+
+	addEventListener(seed.newListener([this](int& val)
+									  {
+										  setup();
+									  }));
+	addEventListener(cycleLength.newListener([this](int& val)
+											 {
+												 setup();
+											 }));
+	addEventListener(blobCount.newListener([this](int& val)
+										   {
+											   setup();
+										   }));
+	addEventListener(noiseLevel.newListener([this](int& val)
+											{
+												setup();
+											}));
+}
+
+bool MTVideoInputSourceTestPattern::isFrameNew()
+{
+	bool isNew = isNewFrame;
+	isNewFrame = false;
+	return isNew;
+}
+
+ofPixels& MTVideoInputSourceTestPattern::getPixels()
+{
+	return pixels;
+}
+
+MTVideoInputFrame MTVideoInputSourceTestPattern::getFrame()
+{
+	return frame;
+}
+
+void MTVideoInputSourceTestPattern::start()
+{}
+
+void MTVideoInputSourceTestPattern::close()
+{
+	std::lock_guard<std::mutex> lock(cycleMutex);
+	cycle.clear();
+	frame = MTVideoInputFrame();
+	pixels.clear();
+	isNewFrame = false;
+}
+
+void MTVideoInputSourceTestPattern::update()
+{
+	uint64_t next = frameNumber + 1;
+	if (paced)
+	{
+		if (frameRate <= 0) return;
+		// Frames are due on a fixed clock, so that a slow stream sees the same frames it would on a fast machine:
+		next = (ofGetElapsedTimeMicros() - startTime) * (uint64_t) frameRate.get() / 1000000;
+		if (next <= frameNumber) return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(cycleMutex);
+		if (cycle.empty()) return;
+		// The cycle is never written to after setup(), so frames are handed out as they are:
+		const auto& image = cycle[next % cycle.size()];
+		frame.image = *image;
+		frame.owner = image;
+	}
+	frame.captureTime = ofGetElapsedTimeMicros();
+
+	frameNumber = next;
+	pixels.setFromExternalPixels(frame.image.data, frame.image.cols, frame.image.rows, frame.image.channels());
+	isNewFrame = true;
+	auto me = this->shared_from_this();
+	frameCapturedEvent.notify(this, me);
+}
+
+void MTVideoInputSourceTestPattern::setup()
+{
+	setup(captureSize->x, captureSize->y, frameRate, deviceID);
+}
+
+void MTVideoInputSourceTestPattern::setup(int width, int height, int framerate, std::string deviceID)
+{
+	if (isDeserializing) return;
+	captureSize.setWithoutEventNotifications(glm::ivec2(width, height));
+	frameRate.setWithoutEventNotifications(framerate);
+	this->deviceID.setWithoutEventNotifications(deviceID);
+
+	auto pattern = getPattern();
+	// Large frames get a shorter cycle rather than gigabytes of memory:
+	size_t frameBytes = (size_t) std::max(1, width) * std::max(1, height) * 3;
+	int length = (int) std::min<size_t>(cycleLength.get(), std::max<size_t>(1, MaxCycleBytes / frameBytes));
+	if (length < cycleLength)
+	{
+		ofLogNotice("MTVideoInputSourceTestPattern") << "The cycle is limited to " << length << " frames at "
+													 << width << "x" << height;
+	}
+
+	// All the randomness comes from the seed, and each frame only depends on its index:
+	cv::RNG rng((uint64_t) seed.get() * 2654435761u + 1);
+	std::vector<BlobPath> paths(pattern == Blobs || pattern == Scene ? blobCount.get() : 0);
+	for (auto& path : paths)
+	{
+		path.radius = rng.uniform(0.03f, 0.12f) * std::min(width, height);
+		path.center = cv::Point2f(rng.uniform(0.25f, 0.75f) * width, rng.uniform(0.25f, 0.75f) * height);
+		path.amplitude = cv::Point2f(rng.uniform(0.05f, 0.25f) * width, rng.uniform(0.05f, 0.25f) * height);
+		path.frequency = cv::Point2i(rng.uniform(1, 4), rng.uniform(1, 4));
+		path.phase = cv::Point2f(rng.uniform(0.0f, (float) CV_2PI), rng.uniform(0.0f, (float) CV_2PI));
+		path.color = cv::Scalar(rng.uniform(96, 256), rng.uniform(96, 256), rng.uniform(96, 256));
+	}
+
+	std::vector<std::shared_ptr<cv::Mat>> frames(length);
+	cv::parallel_for_(cv::Range(0, length), [&](const cv::Range& range)
+	{
+		for (int i = range.start; i < range.end; i++)
+		{
+			frames[i] = std::make_shared<cv::Mat>(height, width, CV_8UC3);
+			render(*frames[i], i, length, pattern, paths);
+		}
+	});
+
+	std::lock_guard<std::mutex> lock(cycleMutex);
+	cycle = std::move(frames);
+	frameNumber = 0;
+	startTime = ofGetElapsedTimeMicros();
+}
+
+MTVideoInputSourceTestPattern::Pattern MTVideoInputSourceTestPattern::getPattern()
+{
+	auto it = std::find(PatternNames.begin(), PatternNames.end(), deviceID.get());
+	if (it == PatternNames.end()) return Scene;
+	return (Pattern) (it - PatternNames.begin());
+}
+
+void MTVideoInputSourceTestPattern::render(cv::Mat& image, int index, int length, Pattern pattern,
+										   const std::vector<BlobPath>& paths)
+{
+	int noiseIndex = index;
+	// Where the frame is in the loop, from 0 to 1:
+	float t = (float) index / length;
+	if (pattern == Scene)
+	{
+		// The last quarter of the cycle is static: motion, lighting and noise all stop, and the frames
+		// are identical. Motion plays over the first three quarters so that the loop has no seam:
+		int moving = std::max(1, length * 3 / 4);
+		t = std::min(index, moving) / (float) moving;
+		noiseIndex = std::min(index, moving);
+	}
+
+	// Lighting. A gradient row is built once and repeated down the image:
+	float brightness = 1;
+	if (pattern == LightingRamp || pattern == Scene)
+	{
+		brightness = 0.6f + 0.4f * std::sin((float) CV_2PI * t);
+		cv::Mat row(1, image.cols, CV_8UC3);
+		auto rowPtr = row.ptr<cv::Vec3b>();
+		for (int x = 0; x < image.cols; x++)
+		{
+			auto level = cv::saturate_cast<uchar>((40 + 160.0f * x / image.cols) * brightness);
+			rowPtr[x] = cv::Vec3b(level, level, level);
+		}
+		cv::repeat(row, image.rows, 1, image);
+	}
+	else
+	{
+		image.setTo(cv::Scalar::all(pattern == Noise ? 128 : 24));
+	}
+
+	for (const auto& path : paths)
+	{
+		float angle = (float) CV_2PI * t;
+		cv::Point2f center(path.center.x + path.amplitude.x * std::sin(angle * path.frequency.x + path.phase.x),
+						   path.center.y + path.amplitude.y * std::sin(angle * path.frequency.y + path.phase.y));
+		// Fixed point coordinates for sub-pixel motion:
+		cv::circle(image, cv::Point(cvRound(center.x * 16), cvRound(center.y * 16)), cvRound(path.radius * 16),
+				   path.color * brightness, cv::FILLED, cv::LINE_AA, 4);
+	}
+
+	if ((pattern == Noise || pattern == Scene) && noiseLevel > 0)
+	{
+		cv::Mat noise(image.size(), CV_16SC3);
+		cv::RNG rng((uint64_t) seed.get() * 2654435761u + noiseIndex + 1);
+		rng.fill(noise, cv::RNG::NORMAL, 0, noiseLevel.get());
+		cv::add(image, noise, image, cv::noArray(), CV_8U);
+	}
+}
@@ -0,0 +1,93 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTVIDEOINPUTSOURCETESTPATTERN_HPP
+#define NERVOUSSTRUCTUREOF_MTVIDEOINPUTSOURCETESTPATTERN_HPP
+
+#include <mutex>
+#include "MTVideoInputSource.hpp"
+
+/**
+ * @brief Generates procedural scenes from a seed, for benchmarks and for testing processes with known
+ * content. The same seed, pattern, size and cycle length always give the same frames, on any machine.
+ * A cycle of frames is rendered in setup() and then played in a loop without copying, so the source
+ * is never the bottleneck. The device ID is the name of the pattern, see PatternNames.
+ */
+class MTVideoInputSourceTestPattern : public MTVideoInputSource
+{
+public:
+	enum Pattern
+	{
+		/// Moving colored discs over a dark background
+		Blobs = 0,
+		/// Gaussian noise over mid gray
+		Noise,
+		/// A gradient whose brightness rises and falls
+		LightingRamp,
+		/// Blobs, noise and lighting changes, with a static period at the end of each cycle
+		Scene
+	};
+
+	static const std::vector<std::string> PatternNames;
+	static const size_t MaxCycleBytes = 512 * 1024 * 1024;
+
+	ofParameter<int> seed;
+	/**
+	 * @brief Number of frames rendered ahead and played in a loop. Motion is periodic over the cycle,
+	 * so the loop has no seam. The cycle is shortened if it would take more than MaxCycleBytes.
+	 */
+	ofParameter<int> cycleLength;
+	ofParameter<int> blobCount;
+	/**
+	 * @brief Standard deviation of the noise, in 8-bit levels.
+	 */
+	ofParameter<int> noiseLevel;
+	/**
+	 * @brief If true, frames are delivered at the frame rate. If false, a new frame is delivered on
+	 * every update(), for measuring how fast a stream can go.
+	 */
+	ofParameter<bool> paced;
+
+	MTVideoInputSourceTestPattern(std::string pattern);
+	bool isFrameNew() override;
+	ofPixels& getPixels() override;
+	MTVideoInputFrame getFrame() override;
+	void start() override;
+	void close() override;
+	void update() override;
+	void setup() override;
+	void setup(int width, int height, int framerate, std::string deviceID) override;
+
+	/**
+	 * @brief The number of frames delivered since setup(). Frame n shows the image at n modulo the length
+	 * of the cycle.
+	 */
+	uint64_t getFrameNumber()
+	{ return frameNumber; }
+
+private:
+	struct BlobPath
+	{
+		cv::Point2f center;
+		cv::Point2f amplitude;
+		/// Whole cycles per loop, so that every path closes on itself
+		cv::Point2i frequency;
+		cv::Point2f phase;
+		float radius;
+		cv::Scalar color;
+	};
+
+	std::vector<std::shared_ptr<cv::Mat>> cycle;
+	std::mutex cycleMutex;
+	MTVideoInputFrame frame;
+	ofPixels pixels;
+	bool isNewFrame = false;
+	uint64_t frameNumber = 0;
+	uint64_t startTime = 0;
+
+	Pattern getPattern();
+	void render(cv::Mat& image, int index, int length, Pattern pattern, const std::vector<BlobPath>& paths);
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTVIDEOINPUTSOURCETESTPATTERN_HPP
@@ -0,0 +1,242 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include "MTVideoInputSourceVideoFile.hpp"
+
+std::string MTVideoInputSourceVideoFile::SearchPath = "";
+
+MTVideoInputSourceVideoFile::MTVideoInputSourceVideoFile(std::string path) :
+		MTVideoInputSource("Video File", "MTVideoInputSourceVideoFile", "Video File", path)
+{
+	pendingSeek.store(-1);
+	pendingSteps.store(0);
+
+	addParameters(playbackMode.set("Playback Mode", RealTime, RealTime, Stepped),
+				  loop.set("Loop", true),
+				  framePosition.set("Frame", 0, 0, 0));
+
+	addEventListener(framePosition.newListener([this](int& val)
+											   {
+												   seek(val);
+											   }));
+	addEventListener(playbackMode.newListener([this](int& val)
+											  {
+												  nextFrameTime = ofGetElapsedTimef();
+											  }));
+
+	if (!capture.open(ofToDataPath(path, true)))
+	{
+		ofLogError("MTVideoInputSourceVideoFile") << "Could not open " << path;
+		isSetupFlag = false;
+	}
+}
+
+MTVideoInputSourceVideoFile::~MTVideoInputSourceVideoFile()
+{
+	// The capture thread must be done with the decoder before it goes away:
+	MTVideoInputSourceVideoFile::close();
+}
+
+bool MTVideoInputSourceVideoFile::isFrameNew()
+{
+	bool isNew = isNewFrame;
+	isNewFrame = false;
+	return isNew;
+}
+
+ofPixels& MTVideoInputSourceVideoFile::getPixels()
+{
+	return pixels;
+}
+
+MTVideoInputFrame MTVideoInputSourceVideoFile::getFrame()
+{
+	return frame;
+}
+
+void MTVideoInputSourceVideoFile::start()
+{}
+
+void MTVideoInputSourceVideoFile::close()
+{
+	captureThread.stop();
+	frame = MTVideoInputFrame();
+	pixels.clear();
+	isNewFrame = false;
+}
+
+void MTVideoInputSourceVideoFile::update()
+{
+	int seekFrame = pendingSeek.exchange(-1);
+	if (seekFrame >= 0)
+	{
+		captureThread.stop();
+		seekDecoder(seekFrame);
+		startDecoding();
+	}
+
+	bool isReceived = false;
+	switch (playbackMode)
+	{
+		case RealTime:
+		{
+			// Catch up if the stream fell behind, keeping only the frame that is due now:
+			double now = ofGetElapsedTimef();
+			while (now >= nextFrameTime && captureThread.receive(frame))
+			{
+				isReceived = true;
+				nextFrame++;
+				nextFrameTime += framePeriod;
+			}
+			// Don't try to catch up after a long stall (i.e. a seek):
+			if (now - nextFrameTime > framePeriod * 4) nextFrameTime = now;
+			break;
+		}
+		case AsFastAsPossible:
+			if (captureThread.receive(frame))
+			{
+				isReceived = true;
+				nextFrame++;
+			}
+			break;
+		case Stepped:
+			if (pendingSteps.load() > 0 && captureThread.receive(frame))
+			{
+				pendingSteps--;
+				isReceived = true;
+				nextFrame++;
+			}
+			break;
+		default:
+			break;
+	}
+
+	if (!isReceived) return;
+
+	if (frameCount > 0) nextFrame %= frameCount;
+	// Frames are decoded ahead, for a file the frame is "captured" when it is played:
+	frame.captureTime = ofGetElapsedTimeMicros();
+	const auto& image = frame.image;
+	pixels.setFromExternalPixels(image.data, image.cols, image.rows, image.channels());
+	framePosition.setWithoutEventNotifications(std::max(0, nextFrame - 1));
+	isNewFrame = true;
+	auto me = this->shared_from_this();
+	frameCapturedEvent.notify(this, me);
+}
+
+void MTVideoInputSourceVideoFile::setup()
+{
+	setup(captureSize->x, captureSize->y, frameRate, deviceID);
+}
+
+void MTVideoInputSourceVideoFile::setup(int width, int height, int framerate, std::string deviceID)
+{
+	if (isDeserializing) return;
+	captureThread.stop();
+
+	if (!capture.isOpened() || deviceID != this->deviceID.get())
+	{
+		capture.open(ofToDataPath(deviceID, true));
+		this->deviceID.setWithoutEventNotifications(deviceID);
+	}
+	if (!capture.isOpened())
+	{
+		ofLogError("MTVideoInputSourceVideoFile") << "Could not open " << deviceID;
+		return;
+	}
+
+	// The size and frame rate are the file's:
+	captureSize.setWithoutEventNotifications(glm::ivec2(capture.get(cv::CAP_PROP_FRAME_WIDTH),
+														capture.get(cv::CAP_PROP_FRAME_HEIGHT)));
+	double fps = capture.get(cv::CAP_PROP_FPS);
+	if (fps <= 0) fps = 30;
+	framePeriod = 1.0 / fps;
+	frameRate.setWithoutEventNotifications((int) std::round(fps));
+	frameCount = std::max(0, (int) capture.get(cv::CAP_PROP_FRAME_COUNT));
+	framePosition.setMax(std::max(0, frameCount - 1));
+
+	seekDecoder(0);
+	startDecoding();
+}
+
+void MTVideoInputSourceVideoFile::seek(int frame)
+{
+	pendingSeek.store(std::max(0, frame));
+}
+
+void MTVideoInputSourceVideoFile::step()
+{
+	pendingSteps++;
+}
+
+void MTVideoInputSourceVideoFile::startDecoding()
+{
+	nextFrameTime = ofGetElapsedTimef();
+	// Decoding ahead is only useful if nothing is dropped, the playback mode decides what is skipped:
+	captureThread.start([this](cv::Mat& image)
+						{
+							return decode(image);
+						}, 8, MTVideoCaptureThread::FIFO);
+}
+
+bool MTVideoInputSourceVideoFile::decode(cv::Mat& image)
+{
+	if (!capture.read(decoded))
+	{
+		if (!loop) return false;
+		capture.set(cv::CAP_PROP_POS_FRAMES, 0);
+		if (!capture.read(decoded)) return false;
+	}
+
+	// Decoders give BGR, the streams expect RGB. The conversion is also the copy into the ring:
+	if (decoded.channels() == 3)
+	{
+		cv::cvtColor(decoded, image, cv::COLOR_BGR2RGB);
+	}
+	else
+	{
+		decoded.copyTo(image);
+	}
+	return true;
+}
+
+void MTVideoInputSourceVideoFile::seekDecoder(int frame)
+{
+	if (frameCount > 0) frame = std::min(frame, frameCount - 1);
+	capture.set(cv::CAP_PROP_POS_FRAMES, frame);
+
+	// Some backends only seek to key frames. Go back a bit and decode forward to the frame:
+	int position = (int) capture.get(cv::CAP_PROP_POS_FRAMES);
+	if (position != frame)
+	{
+		int start = std::max(0, frame - (int) std::ceil(2.0 / framePeriod));
+		capture.set(cv::CAP_PROP_POS_FRAMES, start);
+		position = (int) capture.get(cv::CAP_PROP_POS_FRAMES);
+		while (position < frame && capture.grab())
+		{
+			position++;
+		}
+	}
+
+	nextFrame = frame;
+	framePosition.setWithoutEventNotifications(frame);
+}
+
+std::vector<std::string> MTVideoInputSourceVideoFile::ListVideoFiles()
+{
+	std::vector<std::string> files;
+	ofDirectory dir(SearchPath);
+	if (!dir.exists()) return files;
+	for (auto extension : {"mp4", "mov", "avi", "mkv", "m4v"})
+	{
+		dir.allowExt(extension);
+	}
+	dir.listDir();
+	dir.sort();
+	for (const auto& file : dir)
+	{
+		files.push_back(file.path());
+	}
+	return files;
+}
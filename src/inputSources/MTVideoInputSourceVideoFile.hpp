@@ -0,0 +1,93 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTVIDEOINPUTSOURCEVIDEOFILE_HPP
+#define NERVOUSSTRUCTUREOF_MTVIDEOINPUTSOURCEVIDEOFILE_HPP
+
+#include "MTVideoInputSource.hpp"
+#include "MTVideoCaptureThread.hpp"
+
+/**
+ * @brief Plays a video file through cv::VideoCapture. Frames are decoded ahead on a capture thread into
+ * a ring of buffers, and none are dropped on the way in. The device ID is the path to the file.
+ */
+class MTVideoInputSourceVideoFile : public MTVideoInputSource
+{
+public:
+	enum PlaybackMode
+	{
+		/// At the frame rate of the file. Frames are skipped if the stream falls behind
+		RealTime = 0,
+		/// Every frame, as fast as the stream can take them
+		AsFastAsPossible,
+		/// One frame per call to step()
+		Stepped
+	};
+
+	ofParameter<int> playbackMode;
+	ofParameter<bool> loop;
+	/**
+	 * @brief The frame that is being played. Setting it seeks to that frame.
+	 */
+	ofParameter<int> framePosition;
+
+	/**
+	 * @brief Where the input sources provider looks for video files. Relative paths are relative to the data folder.
+	 */
+	static std::string SearchPath;
+
+	MTVideoInputSourceVideoFile(std::string path);
+	~MTVideoInputSourceVideoFile();
+	bool isFrameNew() override;
+	ofPixels& getPixels() override;
+	MTVideoInputFrame getFrame() override;
+	void start() override;
+	void close() override;
+	void update() override;
+	void setup() override;
+	void setup(int width, int height, int framerate, std::string deviceID) override;
+
+	/**
+	 * @brief Seeks to exactly frame. Thread-safe, takes effect on the next update().
+	 */
+	void seek(int frame);
+	/**
+	 * @brief In Stepped mode, delivers the next frame on the next update(). Thread-safe.
+	 */
+	void step();
+	int getFrameCount()
+	{ return frameCount; }
+
+	static std::vector<std::string> ListVideoFiles();
+
+private:
+	cv::VideoCapture capture;
+	MTVideoCaptureThread captureThread;
+	/// Only used by the capture thread
+	cv::Mat decoded;
+	MTVideoInputFrame frame;
+	ofPixels pixels;
+	bool isNewFrame = false;
+	int frameCount = 0;
+	double framePeriod = 1.0 / 30.0;
+	/// When the next frame is due in RealTime mode, in seconds of ofGetElapsedTimef()
+	double nextFrameTime = 0;
+	/// The index of the frame that will be received next
+	int nextFrame = 0;
+	std::atomic_int pendingSeek;
+	std::atomic_int pendingSteps;
+
+	/**
+	 * @brief Capture thread. Decodes the next frame, converted to RGB.
+	 */
+	bool decode(cv::Mat& image);
+	/**
+	 * @brief Moves the decoder to frame, decoding forward from an earlier position if the backend's seek
+	 * does not land on it exactly. The capture thread must be stopped.
+	 */
+	void seekDecoder(int frame);
+	void startDecoding();
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTVIDEOINPUTSOURCEVIDEOFILE_HPP
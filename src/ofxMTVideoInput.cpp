@@ -3,18 +3,28 @@
 //
 
 #include <processes/MTBackgroundSubstraction2.hpp>
+#include <processes/MTBackgroundSubstractionMedian.hpp>
 #include <inputSources/MTVideoInputSourceOFVideoGrabber.hpp>
+#include <inputSources/MTVideoInputSourceVideoFile.hpp>
+#include <inputSources/MTVideoInputSourceTestPattern.hpp>
 #include "ofxMTVideoInput.h"
 #include "ofXml.h"
 #include "processes/MTThresholdVideoProcess.hpp"
 #include "processes/MTBackgroundSubstractionVideoProcess.hpp"
 #include "processes/MTOpticalFlowVideoProcess.hpp"
+#include "processes/MTBlobGatedOpticalFlow.hpp"
+#include "processes/MTBlobTrackerVideoProcess.hpp"
+#include "processes/MTMotionHistoryVideoProcess.hpp"
+#include "processes/MTPointCloudProcesses.hpp"
 #include "processes/MTImageAdjustmentsVideoProcess.hpp"
 #include "registry.h"
 #include "processes/MTMorphology.hpp"
 #include "MTVideoInputSource.hpp"
 #include "MTVideoInputStream.hpp"
+#include "MTVideoInputCompositor.hpp"
+#include "MTVideoInputStreamGroup.hpp"
 #include "inputSources/MTVideoInputSourceRealSense.hpp"
+#include "inputSources/MTVideoInputSourceRealSenseBag.hpp"
 
 MTVideoInput::MTVideoInput() : MTModel("VideoProcessChains")
 {
@@ -30,9 +40,17 @@ void MTVideoInput::init()
 	if (isInit) return;
 	registerVideoProcess<MTThresholdVideoProcess>("MTThresholdVideoProcess");
 	registerVideoProcess<MTBackgroundSubstraction2>("MTBackgroundSubstraction2");
+	registerVideoProcess<MTBackgroundSubstractionMedian>("MTBackgroundSubstractionMedian");
 	registerVideoProcess<MTMorphologyVideoProcess>("MTMorphologyVideoProcess");
 	registerVideoProcess<MTImageAdjustmentsVideoProcess>("MTImageAdjustmentsVideoProcess");
 	registerVideoProcess<MTOpticalFlowVideoProcess>("MTOpticalFlowVideoProcess");
+	registerVideoProcess<MTBlobGatedOpticalFlow>("MTBlobGatedOpticalFlow");
+	registerVideoProcess<MTBlobTrackerVideoProcess>("MTBlobTrackerVideoProcess");
+	registerVideoProcess<MTMotionHistoryVideoProcess>("MTMotionHistoryVideoProcess");
+	registerVideoProcess<MTPointCloudVoxelGrid>("MTPointCloudVoxelGrid");
+	registerVideoProcess<MTPointCloudFloorRemoval>("MTPointCloudFloorRemoval");
+	registerVideoProcess<MTPointCloudCrop>("MTPointCloudCrop");
+	registerVideoProcess<MTPointCloudHeightMap>("MTPointCloudHeightMap");
 	registerVideoProcess<MTBackgroundSubstractionVideoProcess>("MTBackgroundSubstractionVideoProcess");
 
 	registerInputSource<MTVideoInputSourceOFGrabber>("MTVideoInputSourceOFGrabber", []()
@@ -50,6 +68,34 @@ void MTVideoInput::init()
 		return sources;
 	});
 
+	registerInputSource<MTVideoInputSourceVideoFile>("MTVideoInputSourceVideoFile", []()
+	{
+		std::vector<MTVideoInputSourceInfo> sources;
+		for (const auto& path : MTVideoInputSourceVideoFile::ListVideoFiles())
+		{
+			MTVideoInputSourceInfo info;
+			info.name = ofFilePath::getFileName(path);
+			info.deviceID = path;
+			info.type = "MTVideoInputSourceVideoFile";
+			sources.push_back(info);
+		}
+		return sources;
+	});
+
+	registerInputSource<MTVideoInputSourceTestPattern>("MTVideoInputSourceTestPattern", []()
+	{
+		std::vector<MTVideoInputSourceInfo> sources;
+		for (const auto& pattern : MTVideoInputSourceTestPattern::PatternNames)
+		{
+			MTVideoInputSourceInfo info;
+			info.name = "Test Pattern: " + pattern;
+			info.deviceID = pattern;
+			info.type = "MTVideoInputSourceTestPattern";
+			sources.push_back(info);
+		}
+		return sources;
+	});
+
 	#ifdef MTVI_USE_REALSENSE
 	registerInputSource<MTVideoInputSourceRealSense>("MTVideoInputSourceRealSense", []()
 	{
@@ -65,6 +111,19 @@ void MTVideoInput::init()
 		}
 		return sources;
 	});
+	registerInputSource<MTVideoInputSourceRealSenseBag>("MTVideoInputSourceRealSenseBag", []()
+	{
+		std::vector<MTVideoInputSourceInfo> sources;
+		for (const auto& path : MTVideoInputSourceRealSenseBag::ListRecordings())
+		{
+			MTVideoInputSourceInfo info;
+			info.name = ofFilePath::getFileName(path);
+			info.deviceID = path;
+			info.type = "MTVideoInputSourceRealSenseBag";
+			sources.push_back(info);
+		}
+		return sources;
+	});
 	#endif
 
 	updateInputSources(); // Probably don't need this
@@ -114,6 +173,11 @@ void MTVideoInput::removeStream(int index)
 void MTVideoInput::removeStream(std::shared_ptr<MTVideoInputStream> stream)
 {
 	stream->stopStream();
+	if (compositor != nullptr) compositor->removeStream(stream);
+	for (auto& group : streamGroups)
+	{
+		group->removeStream(stream);
+	}
 	auto dex = ofFind(inputStreams, stream);
 	removeStream(dex);
 
@@ -126,6 +190,11 @@ void MTVideoInput::removeAllStreams()
 		stream->closeStream();
 	}
 
+	if (compositor != nullptr) compositor->clear();
+	for (auto& group : streamGroups)
+	{
+		group->clear();
+	}
 	inputStreams.clear();
 	parameters.clear();
 	MTVideoInputStreamEventArgs args;
@@ -214,6 +283,30 @@ void MTVideoInput::deserialize(ofXml& serializer)
 	}
 }
 
+std::shared_ptr<MTVideoInputCompositor> MTVideoInput::getCompositor()
+{
+	if (compositor == nullptr) compositor = std::make_shared<MTVideoInputCompositor>();
+	return compositor;
+}
+
+std::shared_ptr<MTVideoInputStreamGroup> MTVideoInput::createStreamGroup(std::string name,
+																		 std::vector<std::shared_ptr<MTVideoInputStream>> streams)
+{
+	auto group = std::make_shared<MTVideoInputStreamGroup>(name);
+	for (auto& stream : streams)
+	{
+		group->addStream(stream);
+	}
+	streamGroups.push_back(group);
+	return group;
+}
+
+void MTVideoInput::removeStreamGroup(std::shared_ptr<MTVideoInputStreamGroup> group)
+{
+	group->clear();
+	streamGroups.erase(std::remove(streamGroups.begin(), streamGroups.end(), group), streamGroups.end());
+}
+
 size_t MTVideoInput::getStreamCount()
 {
 	return inputStreams.size();
@@ -221,18 +314,26 @@ size_t MTVideoInput::getStreamCount()
 
 std::shared_ptr<MTVideoInputSource> MTVideoInput::createInputSource(MTVideoInputSourceInfo sourceInfo)
 {
-	auto deviceID = sourceInfo.deviceID;
-	auto inputSource = std::shared_ptr<MTVideoInputSource>(
-			inputSourceRegistry.create<std::string>(sourceInfo.type,
-													std::move(deviceID)));
-	if (inputSource->isSetup())
+	auto key = sourceInfo.type + "/" + sourceInfo.deviceID;
+	auto core = sharedSources[key].lock();
+	if (core == nullptr)
 	{
-		return inputSource;
-	}
-	else
-	{
-		return nullptr;
+		auto deviceID = sourceInfo.deviceID;
+		auto inputSource = std::shared_ptr<MTVideoInputSource>(
+				inputSourceRegistry.create<std::string>(sourceInfo.type,
+														std::move(deviceID)));
+		if (inputSource == nullptr || !inputSource->isSetup())
+		{
+			return nullptr;
+		}
+
+		core = std::make_shared<MTVideoInputSourceShared::Core>(inputSource);
+		sharedSources[key] = core;
+		// Sources may end up on a different device than the one asked for:
+		sharedSources[sourceInfo.type + "/" + inputSource->deviceID.get()] = core;
 	}
+
+	return std::make_shared<MTVideoInputSourceShared>(core);
 }
 
 
@@ -8,10 +8,13 @@
 #include "MTVideoProcess.hpp"
 #include "MTModel.hpp"
 #include "registry.h"
+#include "MTVideoInputSourceShared.hpp"
 
 class MTVideoInputStreamEventArgs;
 class MTVideoInputStream;
 class MTVideoInputSource;
+class MTVideoInputCompositor;
+class MTVideoInputStreamGroup;
 
 struct MTVideoInputSourceInfo
 {
@@ -52,6 +55,21 @@ public:
 	std::vector<MTVideoInputSourceInfo> getInputSources()
 	{ return inputSources; }
 
+	/**
+	 * @brief The compositor that stitches the results of several streams into one output-space canvas.
+	 * Created on first use. Streams have to be added to it explicitly, and are taken out of it when
+	 * they are removed.
+	 */
+	std::shared_ptr<MTVideoInputCompositor> getCompositor();
+
+	/**
+	 * @brief Creates a group that publishes the results of streams as synchronized bundles.
+	 * Removed streams are taken out of their groups.
+	 */
+	std::shared_ptr<MTVideoInputStreamGroup> createStreamGroup(std::string name,
+																std::vector<std::shared_ptr<MTVideoInputStream>> streams);
+	void removeStreamGroup(std::shared_ptr<MTVideoInputStreamGroup> group);
+
 
 	/**
 	 * @brief Instantiates a process from the registry.
@@ -75,10 +93,9 @@ public:
 	}
 
 	/**
- * @brief Instantiates a process from the registry.
- * @param processTypename The type name of the process.
- * @return a shared_ptr<MTVideoProcess> if the type name was found in the registry, or
- * nullptr if the video process could not be instantiated.
+ * @brief Instantiates an input source from the registry. A device is only ever opened once: if a source
+ * with the same type and device ID is already open, an MTVideoInputSourceShared reading from it is returned.
+ * @return nullptr if the input source could not be instantiated.
  */
 	std::shared_ptr<MTVideoInputSource> createInputSource(MTVideoInputSourceInfo inputSourceInfo);
 
@@ -117,6 +134,10 @@ private:
 	ofxMTVideoInput::Registry<MTVideoInputSource, std::string> inputSourceRegistry;
 	std::vector<ProviderFunction> providerFunctions;
 	std::vector<MTVideoInputSourceInfo> inputSources;
+	std::shared_ptr<MTVideoInputCompositor> compositor;
+	std::vector<std::shared_ptr<MTVideoInputStreamGroup>> streamGroups;
+	/// The open devices, by type and device ID
+	std::map<std::string, std::weak_ptr<MTVideoInputSourceShared::Core>> sharedSources;
 	bool isInit = false;
 
 	void addInputSourcesProvider(ProviderFunction function)
@@ -3,11 +3,15 @@
 //
 
 #include <MTVideoInputStream.hpp>
+#include <opencv2/core/hal/intrin.hpp>
 #include "MTBackgroundSubstraction2.hpp"
+#include "MTMorphologyKernels.hpp"
 
 MTBackgroundSubstraction2::MTBackgroundSubstraction2() :
 		MTVideoProcess("Background Substraction 2", "MTBackgroundSubstraction2")
 {
+	// Written into directly every frame, so it can be shared without a copy:
+	registerOutputBuffer(processOutput);
 	parameters.add(
 			erodeSize.set("Erosion Kernel Size", 1, 1, 25),
 			erodeShapeType.set("Erosion Shape Type", 0, 0, 2),
@@ -15,7 +19,8 @@ MTBackgroundSubstraction2::MTBackgroundSubstraction2() :
 			dilateShapeType.set("Dilation Shape Type", 0, 0, 2),
 			threshold.set("Background Threshold", 16, 1, 46),
 			history.set("History Length", 500, 100, 2000),
-			detectShadows.set("Detect Shadows", true)
+			detectShadows.set("Detect Shadows", true),
+			useFusedPostProcessing.set("Fused Post-Processing", true)
 			);
 
 	addEventListener(erodeSize.newListener([this](int args)
@@ -61,7 +66,7 @@ void MTBackgroundSubstraction2::process(MTProcessData& processData)
 {
 	if (needsUpdate) updateInternals();
 
-	if (processData.processStream.type() != CV_8UC1)
+	if (processData.processStream.channels() >= 3)
 	{
 		cv::cvtColor(processData.processStream, processBuffer, cv::COLOR_RGB2GRAY);
 	}
@@ -70,18 +75,131 @@ void MTBackgroundSubstraction2::process(MTProcessData& processData)
 		processBuffer = processData.processStream;
 	}
 
-	bSub->apply(processBuffer, bSubOutput);
-
-	cv::erode(bSubOutput, erodeOutput, erodeKernel);
-	cv::dilate(erodeOutput, dilateOutput, dilateKernel);
+	if (processBuffer.depth() == CV_16U)
+	{
+		processBuffer.convertTo(floatInput, CV_32F);
+		bSub->apply(floatInput, bSubOutput);
+	}
+	else
+	{
+		bSub->apply(processBuffer, bSubOutput);
+	}
 
-	cv::bitwise_and(processData.processStream, dilateOutput, processOutput);
+	if (useFusedPostProcessing &&
+		erodeShapeType == cv::MORPH_RECT &&
+		dilateShapeType == cv::MORPH_RECT &&
+		processData.processStream.type() == CV_8UC1)
+	{
+		fusedPostProcess(bSubOutput, processData.processStream);
+	}
+	else
+	{
+		cv::erode(bSubOutput, erodeOutput, erodeKernel);
+		cv::dilate(erodeOutput, dilateOutput, dilateKernel);
+
+		if (processData.processStream.type() == CV_8UC1)
+		{
+			cv::bitwise_and(processData.processStream, dilateOutput, processOutput);
+		}
+		else
+		{
+			// The mask is single channel, color and 16-bit streams are masked by copying:
+			processOutput.create(processData.processStream.size(), processData.processStream.type());
+			processOutput.setTo(cv::Scalar::all(0));
+			processData.processStream.copyTo(processOutput, dilateOutput);
+		}
+	}
 
 	processData.processResult = processOutput;
 	processData.processStream = processOutput;
 	processData.processMask = dilateOutput;
 }
 
+void MTBackgroundSubstraction2::fusedPostProcess(const cv::Mat& foreground, const cv::Mat& stream)
+{
+	const int rows = foreground.rows;
+	const int cols = foreground.cols;
+	const int e = erodeSize;
+	const int d = dilateSize;
+	// Each strip recomputes a halo of (e + d) rows on each side, so strips should be tall
+	// compared to the kernels:
+	const int stripHeight = std::max(32, 4 * (e + d));
+	const int strips = (rows + stripHeight - 1) / stripHeight;
+
+	dilateOutput.create(foreground.size(), CV_8UC1);
+	processOutput.create(foreground.size(), CV_8UC1);
+
+	cv::parallel_for_(cv::Range(0, strips), [&](const cv::Range& range)
+	{
+		const int erodeSlots = 2 * e + 1;
+		const int dilateSlots = 2 * d + 1;
+		// Horizontally eroded rows, vertically eroded rows, and the vertical dilation of the current row:
+		std::vector<uchar> erodeRing((size_t) erodeSlots * cols);
+		std::vector<uchar> dilateRing((size_t) dilateSlots * cols);
+		std::vector<uchar> verticalMax(cols);
+		std::vector<uchar> scratch(ofxMTVideoInput::morphologyRowScratchSize(cols, std::max(e, d)));
+
+		for (int s = range.start; s < range.end; s++)
+		{
+			const int y0 = s * stripHeight;
+			const int y1 = std::min(rows, y0 + stripHeight);
+			// Next rows to compute in each ring. Rows outside of the image are skipped, which
+			// matches OpenCV's default border for erode and dilate:
+			int nextHorizontal = std::max(0, y0 - d - e);
+			int nextEroded = std::max(0, y0 - d);
+
+			for (int y = y0; y < y1; y++)
+			{
+				const int lastEroded = std::min(rows - 1, y + d);
+				for (; nextEroded <= lastEroded; nextEroded++)
+				{
+					const int lastHorizontal = std::min(rows - 1, nextEroded + e);
+					for (; nextHorizontal <= lastHorizontal; nextHorizontal++)
+					{
+						ofxMTVideoInput::morphologyRowFast(foreground.ptr<uchar>(nextHorizontal),
+														   &erodeRing[(size_t) (nextHorizontal % erodeSlots) * cols],
+														   cols, e, false, scratch.data());
+					}
+
+					uchar* eroded = &dilateRing[(size_t) (nextEroded % dilateSlots) * cols];
+					const int first = std::max(0, nextEroded - e);
+					std::copy_n(&erodeRing[(size_t) (first % erodeSlots) * cols], cols, eroded);
+					for (int r = first + 1; r <= lastHorizontal; r++)
+					{
+						ofxMTVideoInput::combineRowsMinMax(eroded, &erodeRing[(size_t) (r % erodeSlots) * cols],
+														   eroded, cols, false);
+					}
+				}
+
+				const int first = std::max(0, y - d);
+				std::copy_n(&dilateRing[(size_t) (first % dilateSlots) * cols], cols, verticalMax.data());
+				for (int r = first + 1; r <= lastEroded; r++)
+				{
+					ofxMTVideoInput::combineRowsMinMax(verticalMax.data(), &dilateRing[(size_t) (r % dilateSlots) * cols],
+													   verticalMax.data(), cols, true);
+				}
+
+				uchar* mask = dilateOutput.ptr<uchar>(y);
+				ofxMTVideoInput::morphologyRowFast(verticalMax.data(), mask, cols, d, true, scratch.data());
+
+				const uchar* src = stream.ptr<uchar>(y);
+				uchar* dst = processOutput.ptr<uchar>(y);
+				int x = 0;
+#if CV_SIMD128
+				for (; x <= cols - cv::v_uint8x16::nlanes; x += cv::v_uint8x16::nlanes)
+				{
+					cv::v_store(dst + x, cv::v_load(src + x) & cv::v_load(mask + x));
+				}
+#endif
+				for (; x < cols; x++)
+				{
+					dst[x] = src[x] & mask[x];
+				}
+			}
+		}
+	});
+}
+
 std::shared_ptr<MTVideoProcessUI> MTBackgroundSubstraction2::createUI()
 {
 	return std::make_shared<MTBackgroundSubstraction2UI>(shared_from_this(), OF_IMAGE_GRAYSCALE);
@@ -121,4 +239,5 @@ void MTBackgroundSubstraction2UI::draw(ofxImGui::Settings& settings)
 	ofxImGui::AddParameter<int>(vp->erodeShapeType);
 	ofxImGui::AddParameter<int>(vp->dilateSize);
 	ofxImGui::AddParameter<int>(vp->dilateShapeType);
+	ofxImGui::AddParameter<bool>(vp->useFusedPostProcessing);
 }
\ No newline at end of file
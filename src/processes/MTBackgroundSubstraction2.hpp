@@ -21,6 +21,7 @@ public:
 	ofParameter<int> erodeShapeType;
 	ofParameter<int> dilateSize;
 	ofParameter<int> dilateShapeType;
+	ofParameter<bool> useFusedPostProcessing;
 
 	MTBackgroundSubstraction2();
 	void setup() override;
@@ -35,9 +36,19 @@ protected:
 	cv::Mat erodeOutput;
 	cv::Mat dilateOutput;
 	cv::Mat bSubOutput;
+	/// MOG2 only takes 8-bit or float images, 16-bit streams are converted into this
+	cv::Mat floatInput;
 	bool needsUpdate = true;
 
 	void updateInternals();
+
+	/**
+	 * @brief Erodes, dilates and masks the stream in a single pass. The image is split into
+	 * strips of rows, and each strip streams through two ring buffers of rows sized to the
+	 * kernels, so the eroded image is never written out to memory. Only rectangular kernels
+	 * are separable this way; other shapes use the regular three step path.
+	 */
+	void fusedPostProcess(const cv::Mat& foreground, const cv::Mat& stream);
 };
 
 class MTBackgroundSubstraction2UI : public MTVideoProcessUIWithImage
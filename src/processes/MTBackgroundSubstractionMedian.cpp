@@ -0,0 +1,215 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include <MTVideoInputStream.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include "MTBackgroundSubstractionMedian.hpp"
+
+MTBackgroundSubstractionMedian::MTBackgroundSubstractionMedian() :
+		MTVideoProcess("Background Substraction Median", "MTBackgroundSubstractionMedian")
+{
+	// Written into directly every frame, so it can be shared without a copy:
+	registerOutputBuffer(processOutput);
+	parameters.add(
+			erodeSize.set("Erosion Kernel Size", 1, 1, 25),
+			erodeShapeType.set("Erosion Shape Type", 0, 0, 2),
+			dilateSize.set("Dilation Kernel Size", 1, 1, 25),
+			dilateShapeType.set("Dilation Shape Type", 0, 0, 2),
+			threshold.set("Background Threshold", 20, 1, 100),
+			learningStep.set("Learning Step", 1, 1, 16),
+			updateInterval.set("Update Interval", 1, 1, 30)
+	);
+
+	addEventListener(erodeSize.newListener([this](int args)
+										   {
+											   needsUpdate = true;
+										   }));
+	addEventListener(erodeShapeType.newListener([this](int args)
+												{
+													needsUpdate = true;
+												}));
+	addEventListener(dilateSize.newListener([this](int args)
+											{
+												needsUpdate = true;
+											}));
+	addEventListener(dilateShapeType.newListener([this](int args)
+												 {
+													 needsUpdate = true;
+												 }));
+}
+
+void MTBackgroundSubstractionMedian::setup()
+{
+	MTVideoProcess::setup();
+	// The model is re-seeded with the next frame:
+	background.release();
+	frameCount = 0;
+	updateInternals();
+}
+
+void MTBackgroundSubstractionMedian::process(MTProcessData& processData)
+{
+	if (needsUpdate) updateInternals();
+
+	if (processData.processStream.channels() >= 3)
+	{
+		cv::cvtColor(processData.processStream, processBuffer, cv::COLOR_RGB2GRAY);
+	}
+	else
+	{
+		processBuffer = processData.processStream;
+	}
+
+	if (background.size() != processBuffer.size() || background.type() != processBuffer.type())
+	{
+		processBuffer.copyTo(background);
+		frameCount = 0;
+	}
+
+	bSubOutput.create(processBuffer.size(), CV_8UC1);
+	bool updateModel = (frameCount++ % updateInterval.get()) == 0;
+	if (processBuffer.depth() == CV_16U)
+	{
+		applyModel<ushort>(processBuffer, updateModel);
+	}
+	else
+	{
+		applyModel<uchar>(processBuffer, updateModel);
+	}
+
+	cv::erode(bSubOutput, erodeOutput, erodeKernel);
+	cv::dilate(erodeOutput, dilateOutput, dilateKernel);
+
+	if (processBuffer.depth() == CV_8U)
+	{
+		cv::bitwise_and(processBuffer, dilateOutput, processOutput);
+	}
+	else
+	{
+		processOutput.create(processBuffer.size(), processBuffer.type());
+		processOutput.setTo(cv::Scalar::all(0));
+		processBuffer.copyTo(processOutput, dilateOutput);
+	}
+
+	processData.processResult = processOutput;
+	processData.processStream = processOutput;
+	processData.processMask = dilateOutput;
+}
+
+namespace
+{
+	// One row of the model. fg is 0xFF where |src - bg| > thr, and bg moves towards src by at most step:
+	inline void medianRow(const uchar* src, uchar* bg, uchar* fg, int cols, uchar thr, uchar step)
+	{
+		int x = 0;
+#if CV_SIMD128
+		const cv::v_uint8x16 vThr = cv::v_setall_u8(thr);
+		const cv::v_uint8x16 vStep = cv::v_setall_u8(step);
+		for (; x <= cols - cv::v_uint8x16::nlanes; x += cv::v_uint8x16::nlanes)
+		{
+			cv::v_uint8x16 s = cv::v_load(src + x);
+			cv::v_uint8x16 b = cv::v_load(bg + x);
+			// Comparisons yield 0xFF lanes, which is exactly the mask value we want:
+			cv::v_store(fg + x, cv::v_absdiff(s, b) > vThr);
+			// Saturating u8 arithmetic: only one of (s - b), (b - s) is non-zero
+			b = b + cv::v_min(s - b, vStep) - cv::v_min(b - s, vStep);
+			cv::v_store(bg + x, b);
+		}
+#endif
+		for (; x < cols; x++)
+		{
+			int s = src[x];
+			int b = bg[x];
+			fg[x] = std::abs(s - b) > thr ? 255 : 0;
+			bg[x] = (uchar) (b + std::min(std::max(s - b, 0), (int) step)
+							 - std::min(std::max(b - s, 0), (int) step));
+		}
+	}
+
+	inline void medianRow(const ushort* src, ushort* bg, uchar* fg, int cols, ushort thr, ushort step)
+	{
+		int x = 0;
+#if CV_SIMD128
+		const cv::v_uint16x8 vThr = cv::v_setall_u16(thr);
+		const cv::v_uint16x8 vStep = cv::v_setall_u16(step);
+		for (; x <= cols - cv::v_uint8x16::nlanes; x += cv::v_uint8x16::nlanes)
+		{
+			cv::v_uint16x8 mask[2];
+			for (int half = 0; half < 2; half++)
+			{
+				int i = x + half * cv::v_uint16x8::nlanes;
+				cv::v_uint16x8 s = cv::v_load(src + i);
+				cv::v_uint16x8 b = cv::v_load(bg + i);
+				mask[half] = cv::v_absdiff(s, b) > vThr;
+				b = b + cv::v_min(s - b, vStep) - cv::v_min(b - s, vStep);
+				cv::v_store(bg + i, b);
+			}
+			// The 0xFFFF lanes saturate to 0xFF:
+			cv::v_store(fg + x, cv::v_pack(mask[0], mask[1]));
+		}
+#endif
+		for (; x < cols; x++)
+		{
+			int s = src[x];
+			int b = bg[x];
+			fg[x] = std::abs(s - b) > thr ? 255 : 0;
+			bg[x] = (ushort) (b + std::min(std::max(s - b, 0), (int) step)
+							  - std::min(std::max(b - s, 0), (int) step));
+		}
+	}
+}
+
+template<typename T>
+void MTBackgroundSubstractionMedian::applyModel(const cv::Mat& frame, bool updateModel)
+{
+	// Parameters are read once here, the loop body runs on OpenCV's worker threads:
+	const T thr = cv::saturate_cast<T>(threshold.get());
+	const T step = updateModel ? cv::saturate_cast<T>(learningStep.get()) : T(0);
+	const int cols = frame.cols;
+
+	cv::parallel_for_(cv::Range(0, frame.rows), [&](const cv::Range& range)
+	{
+		for (int y = range.start; y < range.end; y++)
+		{
+			medianRow(frame.ptr<T>(y), background.ptr<T>(y), bSubOutput.ptr<uchar>(y), cols, thr, step);
+		}
+	});
+}
+
+std::shared_ptr<MTVideoProcessUI> MTBackgroundSubstractionMedian::createUI()
+{
+	return std::make_shared<MTBackgroundSubstractionMedianUI>(shared_from_this(), OF_IMAGE_GRAYSCALE);
+}
+
+void MTBackgroundSubstractionMedian::updateInternals()
+{
+	erodeKernel = cv::getStructuringElement(erodeShapeType,
+											cv::Size(2 * erodeSize + 1, 2 * erodeSize + 1),
+											cv::Point(erodeSize, erodeSize));
+	dilateKernel = cv::getStructuringElement(dilateShapeType,
+											 cv::Size(2 * dilateSize + 1, 2 * dilateSize + 1),
+											 cv::Point(dilateSize, dilateSize));
+	needsUpdate = false;
+}
+
+MTBackgroundSubstractionMedianUI::
+MTBackgroundSubstractionMedianUI(const std::shared_ptr<MTVideoProcess>& videoProcess, ofImageType imageType) :
+		MTVideoProcessUIWithImage(videoProcess, imageType)
+{
+}
+
+void MTBackgroundSubstractionMedianUI::draw(ofxImGui::Settings& settings)
+{
+	auto vp = std::dynamic_pointer_cast<MTBackgroundSubstractionMedian>(videoProcess.lock());
+	drawImage();
+	ofxImGui::AddParameter<bool>(vp->isActive);
+	ofxImGui::AddParameter<int>(vp->threshold);
+	ofxImGui::AddParameter<int>(vp->learningStep);
+	ofxImGui::AddParameter<int>(vp->updateInterval);
+	ImGui::Separator();
+	ofxImGui::AddParameter<int>(vp->erodeSize);
+	ofxImGui::AddParameter<int>(vp->erodeShapeType);
+	ofxImGui::AddParameter<int>(vp->dilateSize);
+	ofxImGui::AddParameter<int>(vp->dilateShapeType);
+}
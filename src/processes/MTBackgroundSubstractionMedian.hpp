@@ -0,0 +1,69 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTBACKGROUNDSUBSTRACTIONMEDIAN_HPP
+#define NERVOUSSTRUCTUREOF_MTBACKGROUNDSUBSTRACTIONMEDIAN_HPP
+
+#include "MTVideoProcess.hpp"
+#include "MTVideoProcessUI.hpp"
+
+/**
+ * @brief Lightweight background substraction based on an approximate running median
+ * (sigma-delta) model. Every pixel of the background moves towards the current frame
+ * by at most "Learning Step" levels per update, and a pixel is foreground when it is
+ * further than "Background Threshold" from the background. The model update and the
+ * foreground test are done in the same SIMD pass, split into row tiles across threads.
+ * It is much cheaper than MOG2 and well suited to fixed-camera installations.
+ * The erode/dilate/mask outputs are the same as MTBackgroundSubstraction2.
+ * 16-bit streams (i.e. depth) are modeled directly, in which case the threshold and the
+ * learning step are in sensor units (millimetres for depth).
+ */
+class MTBackgroundSubstractionMedian : public MTVideoProcess
+{
+public:
+	// Model
+	ofParameter<int> threshold;
+	ofParameter<int> learningStep;
+	ofParameter<int> updateInterval;
+	// Morphology
+	ofParameter<int> erodeSize;
+	ofParameter<int> erodeShapeType;
+	ofParameter<int> dilateSize;
+	ofParameter<int> dilateShapeType;
+
+	MTBackgroundSubstractionMedian();
+	void setup() override;
+	void process(MTProcessData& processData) override;
+	std::shared_ptr<MTVideoProcessUI> createUI() override;
+
+	/**
+	 * @brief The current background model. Owned by the process, clone it if you need
+	 * to use it outside of the processing thread.
+	 */
+	const cv::Mat& getBackground() { return background; }
+
+protected:
+	cv::Mat background;
+	cv::Mat erodeKernel;
+	cv::Mat dilateKernel;
+	cv::Mat erodeOutput;
+	cv::Mat dilateOutput;
+	cv::Mat bSubOutput;
+	unsigned int frameCount = 0;
+	bool needsUpdate = true;
+
+	void updateInternals();
+	template<typename T>
+	void applyModel(const cv::Mat& frame, bool updateModel);
+};
+
+class MTBackgroundSubstractionMedianUI : public MTVideoProcessUIWithImage
+{
+public:
+	MTBackgroundSubstractionMedianUI(const std::shared_ptr<MTVideoProcess>& videoProcess,
+									 ofImageType imageType);
+	void draw(ofxImGui::Settings& settings) override;
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTBACKGROUNDSUBSTRACTIONMEDIAN_HPP
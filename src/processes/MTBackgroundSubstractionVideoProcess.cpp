@@ -13,6 +13,8 @@
 MTBackgroundSubstractionVideoProcess::MTBackgroundSubstractionVideoProcess() :
 		MTVideoProcess("Background Substraction", "MTBackgroundSubstractionVideoProcess")
 {
+	// Written into directly every frame, so it can be shared without a copy:
+	registerOutputBuffer(processOutput);
 	parameters.add(threshold.set("Background Threshold", 16, 1, 46),
 				   history.set("History Length", 500, 100, 2000),
 				   detectShadows.set("Detect Shadows", true),
@@ -53,10 +55,18 @@ void MTBackgroundSubstractionVideoProcess::process(MTProcessData& processData)
 		bSub->setVarThreshold(threshold);
 		updateParams = false;
 	}
-	bSub->apply(processData.processStream, processBuffer);
+	// MOG2 only takes 8-bit or float images:
+	if (processData.processStream.depth() == CV_16U)
+	{
+		processData.processStream.convertTo(floatInput, CV_32F);
+		bSub->apply(floatInput, processBuffer);
+	}
+	else
+	{
+		bSub->apply(processData.processStream, processBuffer);
+	}
 	if (substractStream)
 	{
-		processBuffer.convertTo(processBuffer, processData.processStream.type());
 //		cv::multiply()
 //		cv::subtract(processData.processStream, processBuffer, processOutput, processData.processStream.depth());
 		cv::bitwise_and(processData.processStream, processData.processStream, processOutput, processBuffer);
@@ -25,6 +25,7 @@ public:
 
 protected:
 	cv::Ptr<cv::BackgroundSubtractorMOG2> bSub;
+	cv::Mat floatInput;
 
 	bool updateParams = true;
 };
@@ -2,4 +2,159 @@
 // Created by Cristobal Mendoza on 10/11/19.
 //
 
+#include <MTVideoInputStream.hpp>
+#include <MTVideoProcessUI.hpp>
 #include "MTBlobGatedOpticalFlow.hpp"
+
+void MTBlobGatedOpticalFlow::notifyEvents()
+{
+	MTVideoProcess::notifyEvents();
+	auto processEventArgs =
+			MTVideoProcessCompleteFastEventArgs<MTBlobGatedOpticalFlow>
+					(processOutput, this);
+	ofNotifyEvent(opticalFlowProcessCompleteFastEvent, processEventArgs, this);
+}
+
+MTBlobGatedOpticalFlow::MTBlobGatedOpticalFlow() :
+		MTVideoProcess("Blob Gated Optical Flow", "MTBlobGatedOpticalFlow")
+{
+	parameters.add(fbPyrScale.set("fbPyrScale", .5, 0, .99));
+	parameters.add(fbLevels.set("fbLevels", 4, 1, 8));
+	parameters.add(fbIterations.set("fbIterations", 2, 1, 8));
+	parameters.add(fbPolyN.set("fbPolyN", 5, 5, 7));
+	parameters.add(fbPolySigma.set("fbPolySigma", 1.5, 1.1, 2));
+	parameters.add(fbUseGaussian.set("fbUseGaussian", false));
+	parameters.add(fbWinSize.set("winSize", 16, 4, 64));
+	parameters.add(regionMargin.set("Region Margin", 16, 0, 128));
+	parameters.add(minBlobArea.set("Min Blob Area", 50, 0, 5000));
+}
+
+void MTBlobGatedOpticalFlow::setup()
+{
+	MTVideoProcess::setup();
+	previousFrame.release();
+	regions.clear();
+	previousRegions.clear();
+	flow.create(processHeight, processWidth, CV_32FC2);
+	flow.setTo(cv::Scalar::all(0));
+}
+
+void MTBlobGatedOpticalFlow::process(MTProcessData& processData)
+{
+	auto& streamBuffer = processData.processStream;
+	if (streamBuffer.channels() >= 3)
+	{
+		cv::cvtColor(streamBuffer, currentFrame, cv::COLOR_RGB2GRAY);
+	}
+	else if (streamBuffer.depth() == CV_16U)
+	{
+		to8Bit(streamBuffer, currentFrame);
+	}
+	else
+	{
+		streamBuffer.copyTo(currentFrame);
+	}
+
+	// Reset the flow if the image size has changed, or on the first frame:
+	if (previousFrame.size() != currentFrame.size())
+	{
+		currentFrame.copyTo(previousFrame);
+		flow.create(currentFrame.size(), CV_32FC2);
+		flow.setTo(cv::Scalar::all(0));
+		previousRegions.clear();
+	}
+
+	// Only the areas that were written last frame need to be cleared:
+	for (const auto& r : previousRegions)
+	{
+		flow(r).setTo(cv::Scalar::all(0));
+	}
+
+	if (processData.processMask.empty() || processData.processMask.size() != currentFrame.size())
+	{
+		regions.clear();
+		regions.emplace_back(0, 0, currentFrame.cols, currentFrame.rows);
+	}
+	else
+	{
+		findRegions(processData.processMask);
+	}
+
+	int flags = fbUseGaussian ? cv::OPTFLOW_FARNEBACK_GAUSSIAN : 0;
+	for (const auto& r : regions)
+	{
+		cv::Mat flowRoi = flow(r);
+		cv::calcOpticalFlowFarneback(previousFrame(r),
+									 currentFrame(r),
+									 flowRoi,
+									 fbPyrScale,
+									 fbLevels,
+									 fbWinSize,
+									 fbIterations,
+									 fbPolyN,
+									 fbPolySigma,
+									 flags);
+	}
+
+	previousRegions = regions;
+	std::swap(previousFrame, currentFrame);
+
+	processOutput = flow;
+	processData.processResult = processOutput;
+}
+
+void MTBlobGatedOpticalFlow::findRegions(const cv::Mat& mask)
+{
+	regions.clear();
+	int count = cv::connectedComponentsWithStats(mask, labels, stats, centroids, 8, CV_32S);
+	cv::Rect frame(0, 0, mask.cols, mask.rows);
+	int margin = regionMargin;
+
+	// Label 0 is the background:
+	for (int i = 1; i < count; i++)
+	{
+		if (stats.at<int>(i, cv::CC_STAT_AREA) < minBlobArea) continue;
+		cv::Rect r(stats.at<int>(i, cv::CC_STAT_LEFT) - margin,
+				   stats.at<int>(i, cv::CC_STAT_TOP) - margin,
+				   stats.at<int>(i, cv::CC_STAT_WIDTH) + margin * 2,
+				   stats.at<int>(i, cv::CC_STAT_HEIGHT) + margin * 2);
+		regions.push_back(r & frame);
+	}
+
+	// Merge overlapping regions so that no pixel gets computed twice. Merging can create
+	// new overlaps, so repeat until nothing changes:
+	bool merged = true;
+	while (merged)
+	{
+		merged = false;
+		for (size_t i = 0; i < regions.size() && !merged; i++)
+		{
+			for (size_t j = i + 1; j < regions.size(); j++)
+			{
+				if ((regions[i] & regions[j]).area() > 0)
+				{
+					regions[i] |= regions[j];
+					regions.erase(regions.begin() + j);
+					merged = true;
+					break;
+				}
+			}
+		}
+	}
+
+	// Farneback needs a minimum amount of pixels to work with:
+	regions.erase(std::remove_if(regions.begin(), regions.end(), [](const cv::Rect& r)
+	{
+		return r.width < 16 || r.height < 16;
+	}), regions.end());
+}
+
+const cv::Vec2f& MTBlobGatedOpticalFlow::getFlowPosition(int x, int y)
+{
+	return flow.at<cv::Vec2f>(y, x);
+}
+
+std::shared_ptr<MTVideoProcessUI> MTBlobGatedOpticalFlow::createUI()
+{
+	return std::make_shared<MTVideoProcessUIWithImage>(shared_from_this(), OF_IMAGE_COLOR);
+}
@@ -1,60 +1,75 @@
-////
-//// Created by Cristobal Mendoza on 10/11/19.
-////
 //
-//#ifndef NERVOUSSTRUCTUREOF_MTBLOBGATEDOPTICALFLOW_HPP
-//#define NERVOUSSTRUCTUREOF_MTBLOBGATEDOPTICALFLOW_HPP
-//
-//#include <stdio.h>
-//#include "ofxCv.h"
-//#include "MTVideoProcess.hpp"
-//#include "registry.h"
-//
-//class MTVideoProcessUI;
-//
-//class MTBlobGatedOpticalFlow : public MTVideoProcess
-//{
-//
-//public:
-//
-//	explicit MTBlobGatedOpticalFlow();
-//
-//	virtual ~MTOpticalFlowVideoProcess()
-//	{}
-//
-//	ofParameter<float> fbPolySigma;
-//	ofParameter<float> fbPyrScale;
-//	ofParameter<int> fbWinSize;
-//	ofParameter<int> fbPolyN;
-//	ofParameter<int> fbIterations;
-//	ofParameter<int> fbLevels;
-//	ofParameter<bool> fbUseGaussian;
-//	ofFastEvent<MTVideoProcessCompleteFastEventArgs<MTOpticalFlowVideoProcess>> opticalFlowProcessCompleteFastEvent;
-//
-//
-//	void notifyEvents() override;
-//
-////	std::shared_ptr<MTVideoProcessUI> createUI() override;
-////	void drawGui(ofxImGui::Settings& settings) override;
-////	virtual void deserialize(ofXml& serializer);
-////	virtual void saveWithSerializer(ofXml& serializer);
-//
-//	/**
-//	 * Returns a cv::Mat with the flow vectors. Input image is unchanged
-//	 */
-//	MTProcessData& process(MTProcessData& processData) override;
-//
-//	const cv::Vec2f& getFlowPosition(int x, int y);
-//
-//private:
-//	ofxCv::FlowFarneback fb;
-//	ofxCv::Flow* curFlow;
-//	cv::Mat workingImage;
-//
-//
-//};
-//
-//
-//
-//
-//#endif //NERVOUSSTRUCTUREOF_MTBLOBGATEDOPTICALFLOW_HPP
+// Created by Cristobal Mendoza on 10/11/19.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTBLOBGATEDOPTICALFLOW_HPP
+#define NERVOUSSTRUCTUREOF_MTBLOBGATEDOPTICALFLOW_HPP
+
+#include <stdio.h>
+#include "ofxCv.h"
+#include "MTVideoProcess.hpp"
+#include "registry.h"
+
+class MTVideoProcessUI;
+
+/**
+ * @brief Farneback optical flow that is only computed inside the foreground regions
+ * of the processMask published by a preceding process (typically a background substraction).
+ * The bounding boxes of the mask's connected components are padded by "Region Margin",
+ * merged when they overlap, and the flow is calculated on those crops only. The rest of
+ * the flow field is zero. If there is no mask in the stream the whole frame is used.
+ */
+class MTBlobGatedOpticalFlow : public MTVideoProcess
+{
+
+public:
+
+	explicit MTBlobGatedOpticalFlow();
+
+	virtual ~MTBlobGatedOpticalFlow()
+	{}
+
+	ofParameter<float> fbPolySigma;
+	ofParameter<float> fbPyrScale;
+	ofParameter<int> fbWinSize;
+	ofParameter<int> fbPolyN;
+	ofParameter<int> fbIterations;
+	ofParameter<int> fbLevels;
+	ofParameter<bool> fbUseGaussian;
+	ofParameter<int> regionMargin;
+	ofParameter<int> minBlobArea;
+	ofFastEvent<MTVideoProcessCompleteFastEventArgs<MTBlobGatedOpticalFlow>> opticalFlowProcessCompleteFastEvent;
+
+	void setup() override;
+	void notifyEvents() override;
+
+	/**
+	 * Returns a cv::Mat with the flow vectors. Input image is unchanged
+	 */
+	void process(MTProcessData& processData) override;
+
+	const cv::Vec2f& getFlowPosition(int x, int y);
+
+	/**
+	 * @brief The regions where flow was calculated in the last frame, in process coordinates.
+	 * Only valid in the processing thread.
+	 */
+	const std::vector<cv::Rect>& getRegions() { return regions; }
+
+	std::shared_ptr<MTVideoProcessUI> createUI() override;
+
+private:
+	cv::Mat previousFrame;
+	cv::Mat currentFrame;
+	cv::Mat flow;
+	cv::Mat labels;
+	cv::Mat stats;
+	cv::Mat centroids;
+	std::vector<cv::Rect> regions;
+	std::vector<cv::Rect> previousRegions;
+
+	void findRegions(const cv::Mat& mask);
+};
+
+
+#endif //NERVOUSSTRUCTUREOF_MTBLOBGATEDOPTICALFLOW_HPP
@@ -0,0 +1,185 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include <MTVideoInputStream.hpp>
+#include "MTBlobTrackerVideoProcess.hpp"
+
+MTBlobTrackerVideoProcess::MTBlobTrackerVideoProcess() :
+		MTVideoProcess("Blob Tracker", "MTBlobTrackerVideoProcess")
+{
+	parameters.add(minArea.set("Min Area", 100, 1, 10000),
+				   maxArea.set("Max Area", 100000, 1, 1000000),
+				   maxDistance.set("Max Match Distance", 50, 1, 500),
+				   persistence.set("Persistence", 5, 0, 120),
+				   computeContours.set("Compute Contours", true));
+}
+
+void MTBlobTrackerVideoProcess::setup()
+{
+	MTVideoProcess::setup();
+	tracks.clear();
+	std::lock_guard<std::mutex> lock(blobsMutex);
+	blobs.clear();
+}
+
+void MTBlobTrackerVideoProcess::process(MTProcessData& processData)
+{
+	cv::Mat mask = processData.processMask.empty() ? processData.processStream : processData.processMask;
+	if (mask.channels() >= 3)
+	{
+		cv::cvtColor(mask, processBuffer, cv::COLOR_RGB2GRAY);
+		mask = processBuffer;
+	}
+	// Labeling only takes 8-bit input. Any non-zero pixel of a 16-bit mask or depth stream is foreground:
+	if (mask.depth() != CV_8U)
+	{
+		processBuffer = mask != 0;
+		mask = processBuffer;
+	}
+
+	detectBlobs(mask);
+	matchBlobs();
+
+	processOutput = mask;
+	processData.processResult = processOutput;
+}
+
+void MTBlobTrackerVideoProcess::detectBlobs(const cv::Mat& mask)
+{
+	detections.clear();
+	// Area, bounding box and centroid in a single labeling pass:
+	int count = cv::connectedComponentsWithStats(mask, labels, stats, centroids, 8, CV_32S);
+
+	// Maps labels to their index in detections:
+	std::vector<int> labelToDetection(count, -1);
+
+	// Label 0 is the background:
+	for (int i = 1; i < count; i++)
+	{
+		int area = stats.at<int>(i, cv::CC_STAT_AREA);
+		if (area < minArea || area > maxArea) continue;
+
+		MTBlob blob;
+		blob.id = -1;
+		blob.area = area;
+		blob.centroid = cv::Point2f((float) centroids.at<double>(i, 0), (float) centroids.at<double>(i, 1));
+		blob.boundingBox = cv::Rect(stats.at<int>(i, cv::CC_STAT_LEFT),
+									stats.at<int>(i, cv::CC_STAT_TOP),
+									stats.at<int>(i, cv::CC_STAT_WIDTH),
+									stats.at<int>(i, cv::CC_STAT_HEIGHT));
+		blob.velocity = cv::Point2f(0, 0);
+		blob.age = 0;
+		labelToDetection[i] = (int) detections.size();
+		detections.push_back(std::move(blob));
+	}
+
+	if (computeContours && !detections.empty())
+	{
+		// A single contour sweep over the whole mask. Each external contour is assigned to
+		// its component by looking up the label under its first point:
+		cv::findContours(mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+		for (auto& contour : contours)
+		{
+			if (contour.empty()) continue;
+			int label = labels.at<int>(contour.front());
+			if (label <= 0 || label >= count || labelToDetection[label] < 0) continue;
+			detections[labelToDetection[label]].contour = std::move(contour);
+		}
+	}
+}
+
+void MTBlobTrackerVideoProcess::matchBlobs()
+{
+	// Collect all the candidate pairs that are close enough, and match the closest ones first:
+	struct Candidate
+	{
+		float distance;
+		size_t track;
+		size_t detection;
+	};
+	std::vector<Candidate> candidates;
+	float maxDistanceSq = maxDistance.get() * maxDistance.get();
+
+	for (size_t t = 0; t < tracks.size(); t++)
+	{
+		const auto& blob = tracks[t].blob;
+		// Predict where the blob should be with its last velocity:
+		cv::Point2f predicted = blob.centroid + blob.velocity * float(tracks[t].framesMissing + 1);
+		for (size_t d = 0; d < detections.size(); d++)
+		{
+			cv::Point2f delta = detections[d].centroid - predicted;
+			float distanceSq = delta.dot(delta);
+			if (distanceSq <= maxDistanceSq)
+			{
+				candidates.push_back({distanceSq, t, d});
+			}
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b)
+	{
+		return a.distance < b.distance;
+	});
+
+	std::vector<bool> trackMatched(tracks.size(), false);
+	std::vector<bool> detectionMatched(detections.size(), false);
+
+	for (const auto& c : candidates)
+	{
+		if (trackMatched[c.track] || detectionMatched[c.detection]) continue;
+		trackMatched[c.track] = true;
+		detectionMatched[c.detection] = true;
+
+		auto& track = tracks[c.track];
+		auto& detection = detections[c.detection];
+		detection.id = track.blob.id;
+		detection.age = track.blob.age + 1;
+		detection.velocity = (detection.centroid - track.blob.centroid) * (1.0f / float(track.framesMissing + 1));
+		track.blob = std::move(detection);
+		track.framesMissing = 0;
+	}
+
+	// Tracks that were not found are kept around for a few frames in case the blob comes back:
+	for (size_t t = 0; t < tracks.size(); t++)
+	{
+		if (!trackMatched[t]) tracks[t].framesMissing++;
+	}
+	tracks.erase(std::remove_if(tracks.begin(), tracks.end(), [this](const Track& track)
+	{
+		return track.framesMissing > persistence;
+	}), tracks.end());
+
+	for (size_t d = 0; d < detections.size(); d++)
+	{
+		if (detectionMatched[d]) continue;
+		Track track;
+		track.blob = std::move(detections[d]);
+		track.blob.id = nextBlobId++;
+		tracks.push_back(std::move(track));
+	}
+
+	std::lock_guard<std::mutex> lock(blobsMutex);
+	blobs.clear();
+	for (const auto& track : tracks)
+	{
+		if (track.framesMissing == 0) blobs.push_back(track.blob);
+	}
+}
+
+void MTBlobTrackerVideoProcess::notifyEvents()
+{
+	MTVideoProcess::notifyEvents();
+	ofNotifyEvent(blobsFastEvent, blobs, this);
+}
+
+std::vector<MTBlob> MTBlobTrackerVideoProcess::getBlobs()
+{
+	std::lock_guard<std::mutex> lock(blobsMutex);
+	return blobs;
+}
+
+std::shared_ptr<MTVideoProcessUI> MTBlobTrackerVideoProcess::createUI()
+{
+	return std::make_shared<MTVideoProcessUIWithImage>(shared_from_this(), OF_IMAGE_GRAYSCALE);
+}
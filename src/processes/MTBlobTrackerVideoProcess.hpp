@@ -0,0 +1,95 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTBLOBTRACKERVIDEOPROCESS_HPP
+#define NERVOUSSTRUCTUREOF_MTBLOBTRACKERVIDEOPROCESS_HPP
+
+#include <mutex>
+#include "MTVideoProcess.hpp"
+#include "MTVideoProcessUI.hpp"
+
+/**
+ * @brief A connected region of the mask, tracked across frames.
+ */
+struct MTBlob
+{
+	/**
+	 * @brief Persistent identifier. A blob keeps its id for as long as it can be matched
+	 * from frame to frame. Ids are not reused.
+	 */
+	int id;
+	/**
+	 * @brief Area in pixels.
+	 */
+	int area;
+	cv::Point2f centroid;
+	cv::Rect boundingBox;
+	/**
+	 * @brief Displacement of the centroid since the previous frame.
+	 */
+	cv::Point2f velocity;
+	/**
+	 * @brief Number of frames the blob has been tracked for.
+	 */
+	int age;
+	/**
+	 * @brief The external contour of the blob. Empty if "Compute Contours" is off.
+	 */
+	std::vector<cv::Point> contour;
+};
+
+/**
+ * @brief Turns a mask into tracked objects. The mask is taken from processMask or, if there is none,
+ * from processStream. Area, centroid and bounding box come from a single connected components pass,
+ * and blobs are matched to the blobs of the previous frame by distance to give them persistent ids.
+ * The result is published once per frame in the processing thread.
+ */
+class MTBlobTrackerVideoProcess : public MTVideoProcess
+{
+public:
+	ofParameter<int> minArea;
+	ofParameter<int> maxArea;
+	ofParameter<float> maxDistance;
+	ofParameter<int> persistence;
+	ofParameter<bool> computeContours;
+
+	/**
+	 * @brief Fires after every frame with the blobs found in that frame. The vector is owned
+	 * by the process, copy it if you need it outside of the listener.
+	 */
+	ofFastEvent<std::vector<MTBlob>> blobsFastEvent;
+
+	MTBlobTrackerVideoProcess();
+	void setup() override;
+	void process(MTProcessData& processData) override;
+	void notifyEvents() override;
+	std::shared_ptr<MTVideoProcessUI> createUI() override;
+
+	/**
+	 * @brief Returns a copy of the blobs found in the last frame. This method is thread-safe.
+	 */
+	std::vector<MTBlob> getBlobs();
+
+protected:
+	struct Track
+	{
+		MTBlob blob;
+		int framesMissing = 0;
+	};
+
+	cv::Mat labels;
+	cv::Mat stats;
+	cv::Mat centroids;
+	std::vector<std::vector<cv::Point>> contours;
+	std::vector<MTBlob> detections;
+	std::vector<Track> tracks;
+	std::vector<MTBlob> blobs;
+	std::mutex blobsMutex;
+	int nextBlobId = 0;
+
+	void detectBlobs(const cv::Mat& mask);
+	void matchBlobs();
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTBLOBTRACKERVIDEOPROCESS_HPP
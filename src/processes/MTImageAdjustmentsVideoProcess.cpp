@@ -7,6 +7,7 @@
 #include "MTAppFrameworkUtils.hpp"
 #include <opencv2/photo.hpp>
 #include "opencv2/imgproc.hpp"
+#include <opencv2/core/hal/intrin.hpp>
 
 #pragma mark Process
 
@@ -25,7 +26,11 @@ MTImageAdjustmentsVideoProcess::MTImageAdjustmentsVideoProcess() : MTVideoProces
 				   gamma.set("Gamma", 1, 0, 2),
 				   brightness.set("Brightness", 0, -1, 1),
 				   contrast.set("Contrast", 0, -1, 1),
-				   denoise.set("Denoise", false));
+				   denoise.set("Denoise", false),
+				   boxBlurRadius.set("Box Blur Radius", 0, 0, 20),
+				   useTemporalDenoise.set("Temporal Denoise", false),
+				   temporalStrength.set("Temporal Strength", 0.7, 0, 0.95),
+				   motionThreshold.set("Motion Threshold", 20, 1, 100));
 	addEventListener(gamma.newListener([this](float args)
 									   {
 										   gammaNeedsUpdate = true;
@@ -69,7 +74,12 @@ void MTImageAdjustmentsVideoProcess::process(MTProcessData& processData)
 {
 	bool flagChanged = false;
 
-	if (processData.processStream.type() != CV_8UC1)
+	if (processData.processStream.depth() == CV_16U)
+	{
+		processData.processStream = to8Bit(processData.processStream, processBuffer);
+		flagChanged = true;
+	}
+	else if (processData.processStream.type() != CV_8UC1)
 	{
 		cv::cvtColor(processData.processStream, processBuffer, cv::COLOR_RGB2GRAY);
 		processData.processStream = processBuffer;
@@ -114,27 +124,134 @@ void MTImageAdjustmentsVideoProcess::process(MTProcessData& processData)
 			updateBC();
 			bcNeedsUpdate = false;
 		}
-		cv::LUT(processBuffer, bcLUT, processBuffer);
+		// processBuffer only holds this frame if one of the steps above wrote to it:
+		cv::LUT(flagChanged ? processBuffer : processData.processStream, bcLUT, processBuffer);
 		flagChanged = true;
 	}
 
+	cv::Mat current = flagChanged ? processBuffer : processData.processStream;
+
 	if (denoise)
 	{
 //		cv::fastNlMeansDenoising(processBuffer, processBuffer);
-		cv::GaussianBlur(processBuffer, processBuffer, cv::Size(7, 7), 0);
+		cv::GaussianBlur(current, processBuffer, cv::Size(7, 7), 0);
+		current = processBuffer;
 	}
 
-	if (flagChanged)
+	if (boxBlurRadius > 0)
 	{
-		processOutput = processBuffer;
-		processData.processStream = processOutput;
-		processData.processResult = processOutput;
+		boxBlur(current, blurBuffer, boxBlurRadius);
+		current = blurBuffer;
+	}
+
+	if (useTemporalDenoise)
+	{
+		temporalDenoise(current, temporalOutput);
+		current = temporalOutput;
 	}
 	else
 	{
-		processOutput = processData.processStream;
-		processData.processResult = processOutput;
+		temporalState.release();
 	}
+
+	processOutput = current;
+	processData.processStream = processOutput;
+	processData.processResult = processOutput;
+}
+
+void MTImageAdjustmentsVideoProcess::boxBlur(const cv::Mat& src, cv::Mat& dst, int radius)
+{
+	dst.create(src.size(), src.type());
+	const cv::Size kernelSize(2 * radius + 1, 2 * radius + 1);
+	const int stripHeight = std::max(32, 4 * radius);
+	const int strips = (src.rows + stripHeight - 1) / stripHeight;
+
+	cv::parallel_for_(cv::Range(0, strips), [&](const cv::Range& range)
+	{
+		for (int s = range.start; s < range.end; s++)
+		{
+			cv::Rect strip(0, s * stripHeight, src.cols, std::min(stripHeight, src.rows - s * stripHeight));
+			cv::Mat dstStrip = dst(strip);
+			// Without BORDER_ISOLATED, OpenCV reads the rows outside of the ROI from the parent Mat
+			// and only extrapolates at the real edges of the frame:
+			cv::blur(src(strip), dstStrip, kernelSize, cv::Point(-1, -1), cv::BORDER_REPLICATE);
+		}
+	});
+}
+
+void MTImageAdjustmentsVideoProcess::temporalDenoise(const cv::Mat& src, cv::Mat& dst)
+{
+	if (temporalState.size() != src.size())
+	{
+		src.convertTo(temporalState, CV_16U, 256);
+	}
+	dst.create(src.size(), CV_8UC1);
+
+	// Weight of the previous frame in 1/256ths. It is capped below 256 so the filter
+	// always follows the input:
+	const int maxWeight = std::min(243, int(std::round(temporalStrength * 256)));
+	const int threshold = motionThreshold;
+	const int scale = maxWeight * 256 / threshold;
+	const int cols = src.cols;
+
+	cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range)
+	{
+		for (int y = range.start; y < range.end; y++)
+		{
+			const uchar* input = src.ptr<uchar>(y);
+			ushort* state = temporalState.ptr<ushort>(y);
+			uchar* output = dst.ptr<uchar>(y);
+			int x = 0;
+
+#if CV_SIMD128
+			const cv::v_uint16x8 vThreshold = cv::v_setall_u16((ushort) threshold);
+			const cv::v_uint16x8 vScale = cv::v_setall_u16((ushort) scale);
+			const cv::v_uint16x8 vOne = cv::v_setall_u16(256);
+			const cv::v_uint16x8 vHalf = cv::v_setall_u16(128);
+			const cv::v_uint32x4 vHalf32 = cv::v_setall_u32(128);
+
+			for (; x <= cols - cv::v_uint8x16::nlanes; x += cv::v_uint8x16::nlanes)
+			{
+				cv::v_uint16x8 current[2];
+				cv::v_expand(cv::v_load(input + x), current[0], current[1]);
+				cv::v_uint16x8 result[2];
+
+				for (int half = 0; half < 2; half++)
+				{
+					ushort* statePtr = state + x + half * cv::v_uint16x8::nlanes;
+					cv::v_uint16x8 previous = cv::v_load(statePtr);
+					cv::v_uint16x8 previous8 = (previous + vHalf) >> 8;
+
+					// Weight of the previous value, from maxWeight (no motion) down to 0 (at the threshold):
+					cv::v_uint16x8 difference = cv::v_min(cv::v_absdiff(current[half], previous8), vThreshold);
+					cv::v_uint32x4 w0, w1;
+					cv::v_mul_expand(vThreshold - difference, vScale, w0, w1);
+					cv::v_uint16x8 weight = cv::v_pack(w0 >> 8, w1 >> 8);
+
+					// new state = ((current << 8) * (256 - w) + previous * w) / 256
+					cv::v_uint32x4 a0, a1, b0, b1;
+					cv::v_mul_expand(current[half] << 8, vOne - weight, a0, a1);
+					cv::v_mul_expand(previous, weight, b0, b1);
+					cv::v_uint16x8 next = cv::v_pack((a0 + b0 + vHalf32) >> 8, (a1 + b1 + vHalf32) >> 8);
+					cv::v_store(statePtr, next);
+					result[half] = next;
+				}
+
+				cv::v_store(output + x, cv::v_rshr_pack<8>(result[0], result[1]));
+			}
+#endif
+			for (; x < cols; x++)
+			{
+				int current = input[x];
+				int previous = state[x];
+				int difference = std::min(std::abs(current - ((previous + 128) >> 8)), threshold);
+				int weight = ((threshold - difference) * scale) >> 8;
+				int next = ((current << 8) * (256 - weight) + previous * weight + 128) >> 8;
+				state[x] = (ushort) next;
+				output[x] = cv::saturate_cast<uchar>((next + 128) >> 8);
+			}
+		}
+	});
 }
 
 std::shared_ptr<MTVideoProcessUI> MTImageAdjustmentsVideoProcess::createUI()
@@ -23,11 +23,17 @@ public:
 	ofParameter<bool> useCLAHE;
 	ofParameter<float> claheClipLimit;
 	ofParameter<bool> denoise;
+	ofParameter<int> boxBlurRadius;
+	ofParameter<bool> useTemporalDenoise;
+	ofParameter<float> temporalStrength;
+	ofParameter<int> motionThreshold;
 
 	MTImageAdjustmentsVideoProcess();
 	void setup() override;
 	void process(MTProcessData& processData) override;
 	std::shared_ptr<MTVideoProcessUI> createUI() override;
+	bool isStateless() override
+	{ return !useTemporalDenoise; }
 
 protected:
 	cv::Mat gammaLUT;
@@ -39,6 +45,25 @@ protected:
 	void updateGammaLUT();
 	void updateBC();
 	void updateCLAHE();
+
+	cv::Mat blurBuffer;
+	cv::Mat temporalState;
+	cv::Mat temporalOutput;
+
+	/**
+	 * @brief Box blur with a cost per pixel that does not depend on the radius. The frame is split
+	 * into strips of rows that are filtered in parallel; each strip reads its halo from the
+	 * neighbouring rows of the full frame, so the result is the same as a single cv::blur.
+	 */
+	void boxBlur(const cv::Mat& src, cv::Mat& dst, int radius);
+
+	/**
+	 * @brief Recursive (IIR) temporal filter. Every pixel is blended with its filtered value from
+	 * the previous frame. The weight of the previous frame drops linearly from temporalStrength
+	 * to 0 as the difference between the two reaches motionThreshold, so moving areas don't smear.
+	 * The state is kept in 8.8 fixed point so that strong filtering still converges.
+	 */
+	void temporalDenoise(const cv::Mat& src, cv::Mat& dst);
 };
 
 #pragma mark UI
@@ -4,14 +4,18 @@
 
 #include <MTVideoInputStream.hpp>
 #include "MTMorphology.hpp"
+#include "MTMorphologyKernels.hpp"
 
 MTMorphologyVideoProcess::
 MTMorphologyVideoProcess() : MTVideoProcess("Morphology", "MTMorphologyVideoProcess")
 {
+	// Written into directly every frame, so it can be shared without a copy:
+	registerOutputBuffer(processOutput);
 	parameters.add(
 			size.set("Kernel Size", 1, 1, 25),
 			shapeType.set("Shape Type", 0, 0, 2),
-			mode.set("Mode", 0, 0, 1)
+			mode.set("Mode", 0, 0, 6),
+			useConstantTime.set("Constant-Time Kernels", false)
 	);
 
 	addEventListener(size.newListener([this](int args)
@@ -34,14 +38,23 @@ void MTMorphologyVideoProcess::process(MTProcessData& processData)
 {
 	if (needsUpdate) updateInternals();
 
-	switch (mode)
+	// The MorphologyMode values match OpenCV's MorphTypes:
+	static const int operations[] = {cv::MORPH_ERODE,
+									 cv::MORPH_DILATE,
+									 cv::MORPH_OPEN,
+									 cv::MORPH_CLOSE,
+									 cv::MORPH_GRADIENT,
+									 cv::MORPH_TOPHAT,
+									 cv::MORPH_BLACKHAT};
+	int operation = operations[std::max((int) Erode, std::min(mode.get(), (int) BlackHat))];
+
+	if (useConstantTime)
+	{
+		ofxMTVideoInput::morphologyFast(processData.processStream, processOutput, operation, shapeType, size);
+	}
+	else
 	{
-		case Erode:
-			cv::erode(processData.processStream, processOutput, kernel);
-			break;
-		case Dilate:
-			cv::dilate(processData.processStream, processOutput, kernel);
-			break;
+		cv::morphologyEx(processData.processStream, processOutput, operation, kernel);
 	}
 
 	processData.processStream = processOutput;
@@ -70,11 +83,12 @@ void MTMorphologyVideoProcessUI::draw(ofxImGui::Settings& settings)
 	ofxImGui::AddRadio(mp->mode, modeLabels);
 	ofxImGui::AddParameter<int>(mp->size);
 	ofxImGui::AddParameter<int>(mp->shapeType);
+	ofxImGui::AddParameter<bool>(mp->useConstantTime);
 }
 
 MTMorphologyVideoProcessUI::MTMorphologyVideoProcessUI(const std::shared_ptr<MTVideoProcess>& videoProcess,
 													   ofImageType imageType) :
 		MTVideoProcessUIWithImage(videoProcess, imageType)
 {
-	modeLabels = {"Erode", "Dilate"};
+	modeLabels = {"Erode", "Dilate", "Open", "Close", "Gradient", "Top Hat", "Black Hat"};
 }
@@ -18,11 +18,17 @@ public:
 	ofParameter<int> size = 0;
 	ofParameter<int> mode;
 	ofParameter<int> shapeType;
+	ofParameter<bool> useConstantTime;
 
 	enum MorphologyMode
 	{
 		Erode = 0,
-		Dilate
+		Dilate,
+		Open,
+		Close,
+		Gradient,
+		TopHat,
+		BlackHat
 	};
 
 
@@ -32,6 +38,8 @@ public:
 	void setup() override;
 	void process(MTProcessData& processData) override;
 	std::shared_ptr<MTVideoProcessUI> createUI() override;
+	bool isStateless() override
+	{ return true; }
 
 protected:
 	cv::Mat kernel;
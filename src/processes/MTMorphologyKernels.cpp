@@ -0,0 +1,418 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include "MTMorphologyKernels.hpp"
+#include <opencv2/core/hal/intrin.hpp>
+#include <cmath>
+#include <limits>
+
+namespace ofxMTVideoInput
+{
+	namespace
+	{
+		// Ellipses are decomposed in at most this many rectangles, which bounds the cost per pixel:
+		const int MaxEllipseRectangles = 6;
+		// Width, in elements, of the column strips of the vertical pass. Small enough for the
+		// pass buffers to stay in cache:
+		const int ColumnStripWidth = 64;
+
+#if CV_SIMD128
+		template<typename T>
+		struct MorphVec;
+
+		template<>
+		struct MorphVec<uchar>
+		{
+			typedef cv::v_uint8x16 type;
+		};
+
+		template<>
+		struct MorphVec<ushort>
+		{
+			typedef cv::v_uint16x8 type;
+		};
+#endif
+
+		struct MinOp
+		{
+			template<typename T>
+			static inline T apply(T a, T b)
+			{ return std::min(a, b); }
+
+#if CV_SIMD128
+			template<typename V>
+			static inline V applyVec(const V& a, const V& b)
+			{ return cv::v_min(a, b); }
+#endif
+
+			template<typename T>
+			static inline T identity()
+			{ return std::numeric_limits<T>::max(); }
+
+			static void combineImages(const cv::Mat& a, const cv::Mat& b, cv::Mat& out)
+			{ cv::min(a, b, out); }
+		};
+
+		struct MaxOp
+		{
+			template<typename T>
+			static inline T apply(T a, T b)
+			{ return std::max(a, b); }
+
+#if CV_SIMD128
+			template<typename V>
+			static inline V applyVec(const V& a, const V& b)
+			{ return cv::v_max(a, b); }
+#endif
+
+			template<typename T>
+			static inline T identity()
+			{ return std::numeric_limits<T>::min(); }
+
+			static void combineImages(const cv::Mat& a, const cv::Mat& b, cv::Mat& out)
+			{ cv::max(a, b, out); }
+		};
+
+		template<typename T, typename Op>
+		inline void combineRows(const T* a, const T* b, T* out, int width)
+		{
+			int x = 0;
+#if CV_SIMD128
+			typedef typename MorphVec<T>::type V;
+			for (; x <= width - V::nlanes; x += V::nlanes)
+			{
+				cv::v_store(out + x, Op::applyVec(cv::v_load(a + x), cv::v_load(b + x)));
+			}
+#endif
+			for (; x < width; x++)
+			{
+				out[x] = Op::apply(a[x], b[x]);
+			}
+		}
+
+		/**
+		 * van Herk/Gil-Werman along the columns. The sequence is padded with the identity of the
+		 * operation and split into blocks of the window size. Each output is the combination of a
+		 * block suffix and a block prefix, so it costs 3 operations per pixel for any radius.
+		 * Whole rows are processed at once, so this pass vectorizes across the columns.
+		 */
+		template<typename T, typename Op>
+		void vhgwColumns(const cv::Mat& src, cv::Mat& dst, int radius)
+		{
+			const int rows = src.rows;
+			const int cols = src.cols;
+			const int window = 2 * radius + 1;
+			const int padded = ((rows + 2 * radius + window - 1) / window) * window;
+			const int strips = (cols + ColumnStripWidth - 1) / ColumnStripWidth;
+			dst.create(src.size(), src.type());
+
+			cv::parallel_for_(cv::Range(0, strips), [&](const cv::Range& range)
+			{
+				std::vector<T> identityRow(ColumnStripWidth, Op::template identity<T>());
+				std::vector<T> g((size_t) padded * ColumnStripWidth);
+				std::vector<T> h((size_t) padded * ColumnStripWidth);
+
+				for (int s = range.start; s < range.end; s++)
+				{
+					const int x0 = s * ColumnStripWidth;
+					const int width = std::min(ColumnStripWidth, cols - x0);
+					auto sourceRow = [&](int p) -> const T*
+					{
+						int y = p - radius;
+						return (y >= 0 && y < rows) ? src.ptr<T>(y) + x0 : identityRow.data();
+					};
+
+					// Prefixes, from the start of each block:
+					for (int p = 0; p < padded; p++)
+					{
+						T* gp = &g[(size_t) p * ColumnStripWidth];
+						const T* sp = sourceRow(p);
+						if (p % window == 0)
+						{
+							std::copy(sp, sp + width, gp);
+						}
+						else
+						{
+							combineRows<T, Op>(gp - ColumnStripWidth, sp, gp, width);
+						}
+					}
+
+					// Suffixes, from the end of each block:
+					for (int p = padded - 1; p >= 0; p--)
+					{
+						T* hp = &h[(size_t) p * ColumnStripWidth];
+						const T* sp = sourceRow(p);
+						if ((p + 1) % window == 0)
+						{
+							std::copy(sp, sp + width, hp);
+						}
+						else
+						{
+							combineRows<T, Op>(hp + ColumnStripWidth, sp, hp, width);
+						}
+					}
+
+					for (int y = 0; y < rows; y++)
+					{
+						combineRows<T, Op>(&h[(size_t) y * ColumnStripWidth],
+										   &g[(size_t) (y + window - 1) * ColumnStripWidth],
+										   dst.ptr<T>(y) + x0,
+										   width);
+					}
+				}
+			});
+		}
+
+		/**
+		 * van Herk/Gil-Werman of a single row. g and h must hold at least
+		 * cols + 4 * radius + 1 elements each.
+		 */
+		template<typename T, typename Op>
+		inline void vhgwRow(const T* s, T* d, int cols, int radius, T* g, T* h)
+		{
+			const int window = 2 * radius + 1;
+			const int padded = ((cols + 2 * radius + window - 1) / window) * window;
+			const T identity = Op::template identity<T>();
+
+			for (int p = 0; p < padded; p++)
+			{
+				int x = p - radius;
+				T v = (x >= 0 && x < cols) ? s[x] : identity;
+				g[p] = (p % window == 0) ? v : Op::apply(g[p - 1], v);
+			}
+
+			for (int p = padded - 1; p >= 0; p--)
+			{
+				int x = p - radius;
+				T v = (x >= 0 && x < cols) ? s[x] : identity;
+				h[p] = ((p + 1) % window == 0) ? v : Op::apply(h[p + 1], v);
+			}
+
+			for (int x = 0; x < cols; x++)
+			{
+				d[x] = Op::apply(h[x], g[x + window - 1]);
+			}
+		}
+
+		/**
+		 * van Herk/Gil-Werman along the rows.
+		 */
+		template<typename T, typename Op>
+		void vhgwRows(const cv::Mat& src, cv::Mat& dst, int radius)
+		{
+			const int cols = src.cols;
+			dst.create(src.size(), src.type());
+
+			cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range)
+			{
+				std::vector<T> g(cols + 4 * radius + 1);
+				std::vector<T> h(cols + 4 * radius + 1);
+
+				for (int y = range.start; y < range.end; y++)
+				{
+					vhgwRow<T, Op>(src.ptr<T>(y), dst.ptr<T>(y), cols, radius, g.data(), h.data());
+				}
+			});
+		}
+
+		/**
+		 * Erosion (MinOp) or dilation (MaxOp) by a union of rectangles, which is the
+		 * min/max of the erosions/dilations by each of them.
+		 */
+		template<typename T, typename Op>
+		void morphologyRectangles(const cv::Mat& src, cv::Mat& dst, const std::vector<cv::Size>& rectangles)
+		{
+			static thread_local cv::Mat rowPass;
+			static thread_local cv::Mat rectanglePass;
+			static thread_local cv::Mat accumulator;
+
+			// With more than one rectangle the source is needed after the first one is written:
+			bool canWriteToDst = rectangles.size() == 1 || dst.data != src.data;
+			cv::Mat& result = canWriteToDst ? dst : accumulator;
+
+			for (size_t i = 0; i < rectangles.size(); i++)
+			{
+				const auto& rectangle = rectangles[i];
+				const cv::Mat* input = &src;
+				if (rectangle.width > 0)
+				{
+					vhgwRows<T, Op>(src, rowPass, rectangle.width);
+					input = &rowPass;
+				}
+
+				cv::Mat& target = (i == 0) ? result : rectanglePass;
+				if (rectangle.height > 0)
+				{
+					vhgwColumns<T, Op>(*input, target, rectangle.height);
+				}
+				else if (input->data != target.data)
+				{
+					input->copyTo(target);
+				}
+
+				if (i > 0)
+				{
+					Op::combineImages(result, rectanglePass, result);
+				}
+			}
+
+			if (!canWriteToDst)
+			{
+				accumulator.copyTo(dst);
+			}
+		}
+
+		template<typename T>
+		void morphologyFastT(const cv::Mat& src, cv::Mat& dst, int operation, const std::vector<cv::Size>& rectangles)
+		{
+			static thread_local cv::Mat first;
+			static thread_local cv::Mat second;
+
+			switch (operation)
+			{
+				case cv::MORPH_ERODE:
+					morphologyRectangles<T, MinOp>(src, dst, rectangles);
+					break;
+				case cv::MORPH_DILATE:
+					morphologyRectangles<T, MaxOp>(src, dst, rectangles);
+					break;
+				case cv::MORPH_OPEN:
+					morphologyRectangles<T, MinOp>(src, first, rectangles);
+					morphologyRectangles<T, MaxOp>(first, dst, rectangles);
+					break;
+				case cv::MORPH_CLOSE:
+					morphologyRectangles<T, MaxOp>(src, first, rectangles);
+					morphologyRectangles<T, MinOp>(first, dst, rectangles);
+					break;
+				case cv::MORPH_GRADIENT:
+					morphologyRectangles<T, MaxOp>(src, first, rectangles);
+					morphologyRectangles<T, MinOp>(src, second, rectangles);
+					cv::subtract(first, second, dst);
+					break;
+				case cv::MORPH_TOPHAT:
+					morphologyRectangles<T, MinOp>(src, first, rectangles);
+					morphologyRectangles<T, MaxOp>(first, second, rectangles);
+					cv::subtract(src, second, dst);
+					break;
+				case cv::MORPH_BLACKHAT:
+					morphologyRectangles<T, MaxOp>(src, first, rectangles);
+					morphologyRectangles<T, MinOp>(first, second, rectangles);
+					cv::subtract(second, src, dst);
+					break;
+				default:
+					src.copyTo(dst);
+					break;
+			}
+		}
+	}
+
+	std::vector<cv::Size> decomposeStructuringElement(int shape, int radius)
+	{
+		std::vector<cv::Size> rectangles;
+		if (radius <= 0)
+		{
+			rectangles.emplace_back(0, 0);
+			return rectangles;
+		}
+
+		switch (shape)
+		{
+			case cv::MORPH_CROSS:
+				rectangles.emplace_back(radius, 0);
+				rectangles.emplace_back(0, radius);
+				break;
+			case cv::MORPH_ELLIPSE:
+			{
+				// Walk the rows of OpenCV's own ellipse from the center outwards. Every change
+				// in the row width starts a new rectangle:
+				cv::Mat element = cv::getStructuringElement(cv::MORPH_ELLIPSE,
+															cv::Size(2 * radius + 1, 2 * radius + 1),
+															cv::Point(radius, radius));
+				std::vector<cv::Size> steps;
+				for (int dy = 0; dy <= radius; dy++)
+				{
+					int halfWidth = cv::countNonZero(element.row(radius - dy)) / 2;
+					if (steps.empty() || steps.back().width != halfWidth)
+					{
+						steps.emplace_back(halfWidth, dy);
+					}
+					else
+					{
+						steps.back().height = dy;
+					}
+				}
+
+				if ((int) steps.size() <= MaxEllipseRectangles)
+				{
+					rectangles = steps;
+				}
+				else
+				{
+					// Every step is inside the ellipse. Large ellipses keep an evenly spaced subset of
+					// them, always including the widest and the tallest one, which gives an inscribed
+					// approximation at a cost that does not grow with the radius:
+					for (int i = 0; i < MaxEllipseRectangles; i++)
+					{
+						auto index = (size_t) std::lround(double(i) * double(steps.size() - 1) /
+														  double(MaxEllipseRectangles - 1));
+						rectangles.push_back(steps[index]);
+					}
+				}
+				break;
+			}
+			default:
+				rectangles.emplace_back(radius, radius);
+				break;
+		}
+
+		return rectangles;
+	}
+
+	void morphologyRowFast(const uchar* src, uchar* dst, int cols, int radius, bool isDilate, uchar* scratch)
+	{
+		uchar* g = scratch;
+		uchar* h = scratch + cols + 4 * radius + 1;
+		if (isDilate)
+		{
+			vhgwRow<uchar, MaxOp>(src, dst, cols, radius, g, h);
+		}
+		else
+		{
+			vhgwRow<uchar, MinOp>(src, dst, cols, radius, g, h);
+		}
+	}
+
+	void combineRowsMinMax(const uchar* a, const uchar* b, uchar* out, int width, bool isMax)
+	{
+		if (isMax)
+		{
+			combineRows<uchar, MaxOp>(a, b, out, width);
+		}
+		else
+		{
+			combineRows<uchar, MinOp>(a, b, out, width);
+		}
+	}
+
+	void morphologyFast(const cv::Mat& src, cv::Mat& dst, int operation, int shape, int radius)
+	{
+		switch (src.type())
+		{
+			case CV_8UC1:
+				morphologyFastT<uchar>(src, dst, operation, decomposeStructuringElement(shape, radius));
+				break;
+			case CV_16UC1:
+				morphologyFastT<ushort>(src, dst, operation, decomposeStructuringElement(shape, radius));
+				break;
+			default:
+			{
+				auto kernel = cv::getStructuringElement(shape,
+														cv::Size(2 * radius + 1, 2 * radius + 1),
+														cv::Point(radius, radius));
+				cv::morphologyEx(src, dst, operation, kernel);
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,51 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTMORPHOLOGYKERNELS_HPP
+#define NERVOUSSTRUCTUREOF_MTMORPHOLOGYKERNELS_HPP
+
+#include "ofxCv.h"
+
+namespace ofxMTVideoInput
+{
+	/**
+	 * @brief Morphology with a cost per pixel that does not depend on the kernel size.
+	 * Rectangles are done as two separable van Herk/Gil-Werman passes. Crosses are the union of
+	 * a horizontal and a vertical line, and ellipses are decomposed into a union of at
+	 * most six centered rectangles. Small ellipses, with up to six distinct row widths, are exact. Larger ones are an inscribed approximation, so their output is slightly different from
+	 * cv::morphologyEx with the same kernel.
+	 * @param src Single channel CV_8U or CV_16U image. Other types fall back to cv::morphologyEx.
+	 * @param dst Output, can be the same as src.
+	 * @param operation One of cv::MORPH_ERODE, MORPH_DILATE, MORPH_OPEN, MORPH_CLOSE,
+	 * MORPH_GRADIENT, MORPH_TOPHAT or MORPH_BLACKHAT.
+	 * @param shape One of cv::MORPH_RECT, MORPH_CROSS or MORPH_ELLIPSE.
+	 * @param radius The kernel is (2 * radius + 1) x (2 * radius + 1).
+	 */
+	void morphologyFast(const cv::Mat& src, cv::Mat& dst, int operation, int shape, int radius);
+
+	/**
+	 * @brief Decomposes a structuring element into a union of centered rectangles, expressed as
+	 * (half width, half height) pairs.
+	 */
+	std::vector<cv::Size> decomposeStructuringElement(int shape, int radius);
+
+	/**
+	 * @brief 1D van Herk/Gil-Werman min (erode) or max (dilate) of a single row, for streaming kernels
+	 * that work one row at a time.
+	 * @param scratch Must hold at least morphologyRowScratchSize(cols, radius) elements.
+	 */
+	void morphologyRowFast(const uchar* src, uchar* dst, int cols, int radius, bool isDilate, uchar* scratch);
+
+	inline size_t morphologyRowScratchSize(int cols, int radius)
+	{
+		return 2 * (size_t) (cols + 4 * radius + 1);
+	}
+
+	/**
+	 * @brief Element-wise min or max of two rows.
+	 */
+	void combineRowsMinMax(const uchar* a, const uchar* b, uchar* out, int width, bool isMax);
+}
+
+#endif //NERVOUSSTRUCTUREOF_MTMORPHOLOGYKERNELS_HPP
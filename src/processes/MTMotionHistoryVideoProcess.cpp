@@ -0,0 +1,201 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include <MTVideoInputStream.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include "MTMotionHistoryVideoProcess.hpp"
+
+MTMotionHistoryVideoProcess::MTMotionHistoryVideoProcess() :
+		MTVideoProcess("Motion History", "MTMotionHistoryVideoProcess")
+{
+	parameters.add(input.set("Input", 0, 0, 2),
+				   decay.set("Decay", 0.95, 0.5, 0.9999),
+				   gain.set("Gain", 0.1, 0, 1),
+				   flowScale.set("Flow Scale", 10, 0.1, 100),
+				   output16Bit.set("16-bit Output", false));
+	// Recreated every frame, so it can be handed out without a copy:
+	registerOutputBuffer(heatmap8);
+	addEventListener(input.newListener([this](int& val)
+									   {
+										   hasWarnedNoFlow = false;
+									   }));
+}
+
+void MTMotionHistoryVideoProcess::setup()
+{
+	MTVideoProcess::setup();
+	accumulator.release();
+	hasWarnedNoFlow = false;
+}
+
+void MTMotionHistoryVideoProcess::process(MTProcessData& processData)
+{
+	cv::Mat source;
+	switch (input)
+	{
+		case FlowMagnitude:
+			source = processData.processResult;
+			if (source.type() != CV_32FC2)
+			{
+				// Once until the chain or the input changes, not on every frame:
+				if (!hasWarnedNoFlow)
+				{
+					ofLogWarning("MTMotionHistoryVideoProcess") << "Flow Magnitude needs a CV_32FC2 flow field in processResult. "
+																 "Add an optical flow process before this one.";
+					hasWarnedNoFlow = true;
+				}
+				processOutput = processData.processStream;
+				processData.processResult = processOutput;
+				return;
+			}
+			break;
+		case Mask:
+			source = processData.processMask.empty() ? processData.processStream : processData.processMask;
+			break;
+		default:
+			source = processData.processStream;
+			break;
+	}
+
+	if (source.channels() == 3)
+	{
+		cv::cvtColor(source, processBuffer, cv::COLOR_RGB2GRAY);
+		source = processBuffer;
+	}
+	else
+	{
+		source = to8Bit(source, processBuffer);
+	}
+
+	if (accumulator.size() != source.size())
+	{
+		accumulator.create(source.size(), CV_16UC1);
+		accumulator.setTo(cv::Scalar::all(0));
+	}
+
+	accumulate(source);
+
+	processOutput = output16Bit ? accumulator : heatmap8;
+	processData.processResult = processOutput;
+}
+
+void MTMotionHistoryVideoProcess::accumulate(const cv::Mat& source)
+{
+	const bool isFlow = source.type() == CV_32FC2;
+	const bool writeHeatmap8 = !output16Bit;
+	if (writeHeatmap8) heatmap8.create(source.size(), CV_8UC1);
+
+	// Q16 decay factor, and a gain that maps an input of 255 at full gain to 65535:
+	const int decayFactor = std::min(65535, int(std::round(decay * 65536)));
+	const int gainFactor = int(std::round(gain * 257));
+	const float magnitudeScale = 255.0f / flowScale;
+	const int cols = source.cols;
+
+	cv::parallel_for_(cv::Range(0, source.rows), [&](const cv::Range& range)
+	{
+		thread_local std::vector<uchar> flowRow;
+		if (isFlow) flowRow.resize(cols);
+
+		for (int y = range.start; y < range.end; y++)
+		{
+			const uchar* in;
+			int x;
+
+			if (isFlow)
+			{
+				// Flow magnitude to 8 bits:
+				const float* flow = source.ptr<float>(y);
+				x = 0;
+#if CV_SIMD128
+				const cv::v_float32x4 vScale = cv::v_setall_f32(magnitudeScale);
+				for (; x <= cols - 8; x += 8)
+				{
+					cv::v_float32x4 fx0, fy0, fx1, fy1;
+					cv::v_load_deinterleave(flow + x * 2, fx0, fy0);
+					cv::v_load_deinterleave(flow + x * 2 + 8, fx1, fy1);
+					cv::v_int32x4 m0 = cv::v_round(cv::v_sqrt(fx0 * fx0 + fy0 * fy0) * vScale);
+					cv::v_int32x4 m1 = cv::v_round(cv::v_sqrt(fx1 * fx1 + fy1 * fy1) * vScale);
+					cv::v_pack_u_store(flowRow.data() + x, cv::v_pack(m0, m1));
+				}
+#endif
+				for (; x < cols; x++)
+				{
+					float fx = flow[x * 2];
+					float fy = flow[x * 2 + 1];
+					flowRow[x] = cv::saturate_cast<uchar>(std::sqrt(fx * fx + fy * fy) * magnitudeScale);
+				}
+				in = flowRow.data();
+			}
+			else
+			{
+				in = source.ptr<uchar>(y);
+			}
+
+			ushort* acc = accumulator.ptr<ushort>(y);
+			uchar* out = writeHeatmap8 ? heatmap8.ptr<uchar>(y) : nullptr;
+			x = 0;
+
+#if CV_SIMD128
+			const cv::v_uint16x8 vDecay = cv::v_setall_u16((ushort) decayFactor);
+			const cv::v_uint16x8 vGain = cv::v_setall_u16((ushort) gainFactor);
+			for (; x <= cols - cv::v_uint8x16::nlanes; x += cv::v_uint8x16::nlanes)
+			{
+				cv::v_uint16x8 i0, i1;
+				cv::v_expand(cv::v_load(in + x), i0, i1);
+				cv::v_uint16x8 a0 = cv::v_load(acc + x);
+				cv::v_uint16x8 a1 = cv::v_load(acc + x + cv::v_uint16x8::nlanes);
+
+				// acc = acc * decay + input * gain, saturating:
+				cv::v_uint32x4 d0, d1, d2, d3;
+				cv::v_mul_expand(a0, vDecay, d0, d1);
+				cv::v_mul_expand(a1, vDecay, d2, d3);
+				a0 = cv::v_pack(d0 >> 16, d1 >> 16) + i0 * vGain;
+				a1 = cv::v_pack(d2 >> 16, d3 >> 16) + i1 * vGain;
+
+				cv::v_store(acc + x, a0);
+				cv::v_store(acc + x + cv::v_uint16x8::nlanes, a1);
+				if (out != nullptr)
+				{
+					cv::v_store(out + x, cv::v_pack(a0 >> 8, a1 >> 8));
+				}
+			}
+#endif
+			for (; x < cols; x++)
+			{
+				int value = int(((unsigned) acc[x] * (unsigned) decayFactor) >> 16) + in[x] * gainFactor;
+				acc[x] = cv::saturate_cast<ushort>(value);
+				if (out != nullptr) out[x] = (uchar) (acc[x] >> 8);
+			}
+		}
+	});
+}
+
+std::shared_ptr<MTVideoProcessUI> MTMotionHistoryVideoProcess::createUI()
+{
+	return std::make_shared<MTMotionHistoryVideoProcessUI>(shared_from_this(), OF_IMAGE_GRAYSCALE);
+}
+
+#pragma mark UI
+
+MTMotionHistoryVideoProcessUI::MTMotionHistoryVideoProcessUI(const std::shared_ptr<MTVideoProcess>& videoProcess,
+															 ofImageType imageType) :
+		MTVideoProcessUIWithImage(videoProcess, imageType)
+{
+	inputLabels = {"Mask", "Flow Magnitude", "Stream"};
+}
+
+void MTMotionHistoryVideoProcessUI::draw(ofxImGui::Settings& settings)
+{
+	auto vp = std::dynamic_pointer_cast<MTMotionHistoryVideoProcess>(videoProcess.lock());
+	drawImage();
+	ofxImGui::AddParameter<bool>(vp->isActive);
+	ofxImGui::AddRadio(vp->input, inputLabels);
+	ofxImGui::AddParameter<float>(vp->decay);
+	ofxImGui::AddParameter<float>(vp->gain);
+	if (vp->input == MTMotionHistoryVideoProcess::FlowMagnitude)
+	{
+		ofxImGui::AddParameter<float>(vp->flowScale);
+	}
+	ofxImGui::AddParameter<bool>(vp->output16Bit);
+}
@@ -0,0 +1,66 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTMOTIONHISTORYVIDEOPROCESS_HPP
+#define NERVOUSSTRUCTUREOF_MTMOTIONHISTORYVIDEOPROCESS_HPP
+
+#include "MTVideoProcess.hpp"
+#include "MTVideoProcessUI.hpp"
+
+/**
+ * @brief Accumulates motion into a heatmap that fades out over time. Every frame the accumulator
+ * is multiplied by "Decay" and the input, scaled by "Gain", is added to it. The accumulator is
+ * a 16-bit fixed point image (0 to 1 maps to 0 to 65535) and the whole update is a single SIMD pass,
+ * split into row tiles across threads.
+ * The heatmap is published in processResult, as CV_8UC1 or CV_16UC1. processStream is passed along unchanged.
+ */
+class MTMotionHistoryVideoProcess : public MTVideoProcess
+{
+public:
+	ofParameter<int> input;
+	ofParameter<float> decay;
+	ofParameter<float> gain;
+	ofParameter<float> flowScale;
+	ofParameter<bool> output16Bit;
+
+	enum MotionInput
+	{
+		/// processMask, or processStream if there is no mask
+		Mask = 0,
+		/// The magnitude of a CV_32FC2 flow field in processResult, e.g. from MTOpticalFlowVideoProcess
+		FlowMagnitude,
+		/// The brightness of processStream
+		Stream
+	};
+
+	MTMotionHistoryVideoProcess();
+	void setup() override;
+	void process(MTProcessData& processData) override;
+	std::shared_ptr<MTVideoProcessUI> createUI() override;
+
+	/**
+	 * @brief The 16-bit accumulator. Owned by the process, clone it if you need it outside of
+	 * the processing thread.
+	 */
+	const cv::Mat& getAccumulator() { return accumulator; }
+
+protected:
+	cv::Mat accumulator;
+	cv::Mat heatmap8;
+	bool hasWarnedNoFlow = false;
+
+	void accumulate(const cv::Mat& source);
+};
+
+class MTMotionHistoryVideoProcessUI : public MTVideoProcessUIWithImage
+{
+public:
+	MTMotionHistoryVideoProcessUI(const std::shared_ptr<MTVideoProcess>& videoProcess,
+								  ofImageType imageType);
+	void draw(ofxImGui::Settings& settings) override;
+
+	std::vector<std::string> inputLabels;
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTMOTIONHISTORYVIDEOPROCESS_HPP
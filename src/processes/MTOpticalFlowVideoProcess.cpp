@@ -8,6 +8,7 @@
 
 #include <MTVideoInputStream.hpp>
 #include <MTVideoProcessUI.hpp>
+#include <opencv2/core/hal/intrin.hpp>
 #include "processes/MTOpticalFlowVideoProcess.hpp"
 
 
@@ -18,6 +19,15 @@ void MTOpticalFlowVideoProcess::notifyEvents()
 			MTVideoProcessCompleteFastEventArgs<MTOpticalFlowVideoProcess>
 					(processOutput, this);
 	ofNotifyEvent(opticalFlowProcessCompleteFastEvent, processEventArgs, this);
+
+	if (!usefb)
+	{
+		ofNotifyEvent(pointTracksFastEvent, pointTracks, this);
+	}
+	else if (useSummary)
+	{
+		ofNotifyEvent(flowSummaryFastEvent, flowSummary, this);
+	}
 }
 
 MTOpticalFlowVideoProcess::MTOpticalFlowVideoProcess() :
@@ -31,38 +41,42 @@ MTOpticalFlowVideoProcess::MTOpticalFlowVideoProcess() :
 	parameters.add(fbPolySigma.set("fbPolySigma", 1.5, 1.1, 2));
 	parameters.add(fbUseGaussian.set("fbUseGaussian", false));
 	parameters.add(fbWinSize.set("winSize", 16, 4, 64));
+	parameters.add(lkMaxFeatures.set("lkMaxFeatures", 200, 1, 2000));
+	parameters.add(lkQualityLevel.set("lkQualityLevel", 0.01, 0.001, 0.2));
+	parameters.add(lkMinDistance.set("lkMinDistance", 8, 1, 64));
+	parameters.add(lkWinSize.set("lkWinSize", 21, 5, 64));
+	parameters.add(lkMaxLevel.set("lkMaxLevel", 3, 0, 8));
+	parameters.add(lkRedetectInterval.set("lkRedetectInterval", 10, 1, 120));
+	parameters.add(lkMinTracks.set("lkMinTracks", 50, 0, 2000));
 	parameters.add(useThreshold.set("Use Threshold Filter", false));
 	parameters.add(threshold.set("Threshold", 0, 0, 5000));
+	parameters.add(useSummary.set("Publish Flow Summary", false));
+	parameters.add(summaryColumns.set("Summary Columns", 16, 1, 128));
+	parameters.add(summaryRows.set("Summary Rows", 12, 1, 128));
 }
 
 void MTOpticalFlowVideoProcess::process(MTProcessData& processData)
 {
 
-	if (usefb)
-	{
-		curFlow = &fb;
-		fb.setPyramidScale(fbPyrScale);
-		fb.setNumLevels(fbLevels);
-		fb.setWindowSize(fbWinSize);
-		fb.setNumIterations(fbIterations);
-		fb.setPolyN(fbPolyN);
-		fb.setPolySigma(fbPolySigma);
-		fb.setUseGaussian(fbUseGaussian);
-//		fb.getFlow();
-	}
-	else
+	if (!usefb)
 	{
-		curFlow = &lk;
-		lk.setMaxFeatures(lkMaxFeatures);
-		lk.setQualityLevel(lkQualityLevel);
-		lk.setMinDistance(lkMinDistance);
-		lk.setWindowSize(lkWinSize);
-		lk.setMaxLevel(lkMaxLevel);
+		processSparse(processData);
+		return;
 	}
 
+	fb.setPyramidScale(fbPyrScale);
+	fb.setNumLevels(fbLevels);
+	fb.setWindowSize(fbWinSize);
+	fb.setNumIterations(fbIterations);
+	fb.setPolyN(fbPolyN);
+	fb.setPolySigma(fbPolySigma);
+	fb.setUseGaussian(fbUseGaussian);
+
+	cv::Mat input = to8Bit(processData.processStream, processBuffer);
+
 	// Check to see if the image size has changed. If so, reset the flow:
-	if (fb.getWidth() != processData.processStream.cols ||
-		fb.getHeight() != processData.processStream.rows)
+	if (fb.getWidth() != input.cols ||
+		fb.getHeight() != input.rows)
 	{
 		// Check for the special case of the first capture frame:
 		// If getWidth is 0 then we are starting up capture, so we should
@@ -73,34 +87,270 @@ void MTOpticalFlowVideoProcess::process(MTProcessData& processData)
 		}
 	}
 
-	curFlow->calcOpticalFlow(processData.processStream);
+	fb.calcOpticalFlow(input);
 
-	if (useThreshold)
+	const cv::Mat& flow = fb.getFlow();
+	if (flow.empty())
 	{
-		cv::Mat buf;
-		ofxCv::imitate(buf, fb.getFlow());
-		cv::pow(fb.getFlow(), 2, buf);
-		auto totalScalar = cv::sum(buf);
-//		float total = std::abs(totalScalar[0]) + std::abs(totalScalar[1]);
-		float total = totalScalar[0] + totalScalar[1];
-		if (total < threshold)
+		processOutput = flow;
+		processData.processResult = processOutput;
+		return;
+	}
+
+	// The threshold uses the energy from the summary pass, so we don't need an extra
+	// pow/sum over the field:
+	if (useThreshold || useSummary)
+	{
+		computeFlowSummary(flow);
+	}
+
+	bool isBelowThreshold = useThreshold && flowSummary.totalEnergy < threshold;
+
+	if (useSummary)
+	{
+		if (isBelowThreshold)
 		{
-			ofxCv::imitate(processOutput, fb.getFlow());
-			processOutput = fb.getFlow().zeros(fb.getFlow().size(), fb.getFlow().type());
+			flowSummary.vectors.setTo(cv::Scalar::all(0));
+			flowSummary.magnitudes.setTo(cv::Scalar::all(0));
 		}
-		else
+		processOutput = flowSummary.vectors;
+	}
+	else if (isBelowThreshold)
+	{
+		if (zeroFlow.size() != flow.size() || zeroFlow.type() != flow.type())
 		{
-			processOutput = fb.getFlow();
+			zeroFlow = cv::Mat::zeros(flow.size(), flow.type());
 		}
+		processOutput = zeroFlow;
 	}
 	else
 	{
-		processOutput = fb.getFlow();
+		processOutput = flow;
 	}
 
 	processData.processResult = processOutput;
 }
 
+void MTOpticalFlowVideoProcess::computeFlowSummary(const cv::Mat& flow)
+{
+	const int gridCols = std::min(summaryColumns.get(), flow.cols);
+	const int gridRows = std::min(summaryRows.get(), flow.rows);
+	flowSummary.vectors.create(gridRows, gridCols, CV_32FC2);
+	flowSummary.magnitudes.create(gridRows, gridCols, CV_32FC1);
+	cellEnergy.create(gridRows, gridCols, CV_64FC1);
+	cellMaxMagnitude.create(gridRows, gridCols, CV_32FC1);
+
+	// Each grid row is independent, so the rows of cells are split across threads:
+	cv::parallel_for_(cv::Range(0, gridRows), [&](const cv::Range& range)
+	{
+		for (int gy = range.start; gy < range.end; gy++)
+		{
+			const int y0 = gy * flow.rows / gridRows;
+			const int y1 = (gy + 1) * flow.rows / gridRows;
+			auto vectors = flowSummary.vectors.ptr<cv::Vec2f>(gy);
+			auto magnitudes = flowSummary.magnitudes.ptr<float>(gy);
+			auto energy = cellEnergy.ptr<double>(gy);
+			auto maxMagnitude = cellMaxMagnitude.ptr<float>(gy);
+
+			for (int gx = 0; gx < gridCols; gx++)
+			{
+				const int x0 = gx * flow.cols / gridCols;
+				const int x1 = (gx + 1) * flow.cols / gridCols;
+				double sumX = 0, sumY = 0, sumMagnitude = 0, sumSquared = 0;
+				float cellMax = 0;
+
+				for (int y = y0; y < y1; y++)
+				{
+					const float* row = flow.ptr<float>(y);
+					int x = x0;
+#if CV_SIMD128
+					cv::v_float32x4 vSumX = cv::v_setzero_f32();
+					cv::v_float32x4 vSumY = cv::v_setzero_f32();
+					cv::v_float32x4 vSumMagnitude = cv::v_setzero_f32();
+					cv::v_float32x4 vSumSquared = cv::v_setzero_f32();
+					cv::v_float32x4 vMax = cv::v_setzero_f32();
+					for (; x <= x1 - cv::v_float32x4::nlanes; x += cv::v_float32x4::nlanes)
+					{
+						cv::v_float32x4 fx, fy;
+						cv::v_load_deinterleave(row + x * 2, fx, fy);
+						cv::v_float32x4 squared = fx * fx + fy * fy;
+						cv::v_float32x4 magnitude = cv::v_sqrt(squared);
+						vSumX += fx;
+						vSumY += fy;
+						vSumMagnitude += magnitude;
+						vSumSquared += squared;
+						vMax = cv::v_max(vMax, magnitude);
+					}
+					sumX += cv::v_reduce_sum(vSumX);
+					sumY += cv::v_reduce_sum(vSumY);
+					sumMagnitude += cv::v_reduce_sum(vSumMagnitude);
+					sumSquared += cv::v_reduce_sum(vSumSquared);
+					cellMax = std::max(cellMax, cv::v_reduce_max(vMax));
+#endif
+					for (; x < x1; x++)
+					{
+						float fx = row[x * 2];
+						float fy = row[x * 2 + 1];
+						float squared = fx * fx + fy * fy;
+						float magnitude = std::sqrt(squared);
+						sumX += fx;
+						sumY += fy;
+						sumMagnitude += magnitude;
+						sumSquared += squared;
+						cellMax = std::max(cellMax, magnitude);
+					}
+				}
+
+				double count = double(x1 - x0) * double(y1 - y0);
+				vectors[gx] = cv::Vec2f(float(sumX / count), float(sumY / count));
+				magnitudes[gx] = float(sumMagnitude / count);
+				energy[gx] = sumSquared;
+				maxMagnitude[gx] = cellMax;
+			}
+		}
+	});
+
+	// These are tiny, the full-resolution field is not touched again:
+	double maxValue = 0;
+	cv::minMaxLoc(cellMaxMagnitude, nullptr, &maxValue);
+	flowSummary.totalEnergy = float(cv::sum(cellEnergy)[0]);
+	flowSummary.maxMagnitude = float(maxValue);
+	flowSummary.meanMagnitude = float(cv::mean(flowSummary.magnitudes)[0]);
+}
+
+void MTOpticalFlowVideoProcess::processSparse(MTProcessData& processData)
+{
+	auto& streamBuffer = processData.processStream;
+	if (streamBuffer.channels() >= 3)
+	{
+		cv::cvtColor(streamBuffer, workingImage, cv::COLOR_RGB2GRAY);
+	}
+	else
+	{
+		workingImage = to8Bit(streamBuffer, processBuffer);
+	}
+
+	// The previous pyramid can only be reused if it was built with the same window and levels,
+	// and from an image of the same size:
+	if (pyramidWinSize != lkWinSize.get() || pyramidLevels != lkMaxLevel.get() ||
+		(!previousPyramid.empty() && previousPyramid.front().size() != workingImage.size()))
+	{
+		resetTracks();
+		pyramidWinSize = lkWinSize;
+		pyramidLevels = lkMaxLevel;
+	}
+
+	cv::Size winSize(pyramidWinSize, pyramidWinSize);
+	int levels = cv::buildOpticalFlowPyramid(workingImage, currentPyramid, winSize, pyramidLevels);
+
+	if (!previousPyramid.empty() && !pointTracks.empty())
+	{
+		cv::calcOpticalFlowPyrLK(previousPyramid, currentPyramid, previousPoints, currentPoints,
+								 trackStatus, trackError, winSize, levels);
+
+		// Keep the tracks that were found and are still in the frame:
+		cv::Rect2f frame(0, 0, workingImage.cols, workingImage.rows);
+		size_t kept = 0;
+		for (size_t i = 0; i < pointTracks.size(); i++)
+		{
+			if (!trackStatus[i] || !frame.contains(currentPoints[i])) continue;
+			auto& track = pointTracks[i];
+			track.velocity = currentPoints[i] - track.position;
+			track.position = currentPoints[i];
+			track.age++;
+			pointTracks[kept++] = track;
+		}
+		pointTracks.resize(kept);
+	}
+	else
+	{
+		pointTracks.clear();
+	}
+
+	framesSinceDetection++;
+	if ((int) pointTracks.size() < lkMinTracks.get() || framesSinceDetection >= lkRedetectInterval.get())
+	{
+		// Gate the detection with the mask of a preceding process, if there is one:
+		if (processData.processMask.size() == workingImage.size() &&
+			processData.processMask.type() == CV_8UC1)
+		{
+			detectFeatures(workingImage, processData.processMask);
+		}
+		else
+		{
+			detectFeatures(workingImage, cv::Mat());
+		}
+		framesSinceDetection = 0;
+	}
+
+	previousPoints.resize(pointTracks.size());
+	for (size_t i = 0; i < pointTracks.size(); i++)
+	{
+		previousPoints[i] = pointTracks[i].position;
+	}
+	std::swap(previousPyramid, currentPyramid);
+
+	float total = 0;
+	for (const auto& track : pointTracks)
+	{
+		total += track.velocity.dot(track.velocity);
+	}
+	bool isBelowThreshold = useThreshold && total < threshold;
+
+	processOutput.create((int) pointTracks.size(), 1, CV_32FC4);
+	for (size_t i = 0; i < pointTracks.size(); i++)
+	{
+		const auto& track = pointTracks[i];
+		processOutput.at<cv::Vec4f>((int) i) = isBelowThreshold ?
+											   cv::Vec4f(track.position.x, track.position.y, 0, 0) :
+											   cv::Vec4f(track.position.x, track.position.y,
+														 track.velocity.x, track.velocity.y);
+	}
+
+	processData.processResult = processOutput;
+}
+
+void MTOpticalFlowVideoProcess::detectFeatures(const cv::Mat& gray, const cv::Mat& mask)
+{
+	int maxNewFeatures = lkMaxFeatures.get() - (int) pointTracks.size();
+	if (maxNewFeatures <= 0) return;
+
+	// Don't detect features on top of the points we are already tracking:
+	if (mask.empty())
+	{
+		featureMask.create(gray.size(), CV_8UC1);
+		featureMask.setTo(cv::Scalar(255));
+	}
+	else
+	{
+		mask.copyTo(featureMask);
+	}
+	for (const auto& track : pointTracks)
+	{
+		cv::circle(featureMask, track.position, lkMinDistance, cv::Scalar(0), -1);
+	}
+
+	cv::goodFeaturesToTrack(gray, detectedPoints, maxNewFeatures, lkQualityLevel, lkMinDistance, featureMask);
+
+	for (const auto& point : detectedPoints)
+	{
+		MTPointTrack track;
+		track.id = nextTrackId++;
+		track.position = point;
+		track.velocity = cv::Point2f(0, 0);
+		track.age = 0;
+		pointTracks.push_back(track);
+	}
+}
+
+void MTOpticalFlowVideoProcess::resetTracks()
+{
+	pointTracks.clear();
+	previousPoints.clear();
+	previousPyramid.clear();
+	framesSinceDetection = 0;
+}
+
 const cv::Vec2f& MTOpticalFlowVideoProcess::getFlowPosition(int x, int y)
 {
 	return fb.getFlow().at<cv::Vec2f>(y, x);
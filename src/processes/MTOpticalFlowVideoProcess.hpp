@@ -16,6 +16,58 @@
 
 class MTVideoProcessUI;
 
+/**
+ * @brief A coarse summary of a dense flow field. The field is divided into a grid
+ * of cells, and each cell holds the average flow vector and the average magnitude of
+ * the pixels inside of it.
+ */
+struct MTFlowSummary
+{
+	/**
+	 * @brief CV_32FC2, one average flow vector per grid cell.
+	 */
+	cv::Mat vectors;
+	/**
+	 * @brief CV_32FC1, the average flow magnitude per grid cell.
+	 */
+	cv::Mat magnitudes;
+	/**
+	 * @brief The sum of the squared flow magnitudes over the whole field.
+	 */
+	float totalEnergy = 0;
+	/**
+	 * @brief The largest flow magnitude found in the field.
+	 */
+	float maxMagnitude = 0;
+	/**
+	 * @brief The average of the cell magnitudes.
+	 */
+	float meanMagnitude = 0;
+};
+
+/**
+ * @brief A feature point tracked by the sparse (Lucas-Kanade) mode.
+ */
+struct MTPointTrack
+{
+	/**
+	 * @brief Persistent identifier of the track. Ids are not reused.
+	 */
+	int id;
+	/**
+	 * @brief Position in process coordinates.
+	 */
+	cv::Point2f position;
+	/**
+	 * @brief Displacement since the previous frame.
+	 */
+	cv::Point2f velocity;
+	/**
+	 * @brief Number of frames the point has been tracked for.
+	 */
+	int age;
+};
+
 class MTOpticalFlowVideoProcess : public MTVideoProcess
 {
 
@@ -38,13 +90,28 @@ public:
 	ofParameter<int> fbIterations;
 	ofParameter<int> fbLevels;
 	ofParameter<int> lkWinSize;
+	ofParameter<int> lkRedetectInterval;
+	ofParameter<int> lkMinTracks;
 	ofParameter<bool> fbUseGaussian;
 	ofParameter<bool> usefb;
 	ofParameter<bool> useThreshold;
 	ofParameter<int> threshold;
+	ofParameter<bool> useSummary;
+	ofParameter<int> summaryColumns;
+	ofParameter<int> summaryRows;
 //	ofParameter<bool> useMorphFilter;
 //	ofParameter<int> kernelSize;
 	ofFastEvent<MTVideoProcessCompleteFastEventArgs<MTOpticalFlowVideoProcess>> opticalFlowProcessCompleteFastEvent;
+	/**
+	 * @brief Fires after every frame when "Publish Flow Summary" is on. The summary is
+	 * owned by the process, copy what you need if you are going to use it in a different thread.
+	 */
+	ofFastEvent<MTFlowSummary> flowSummaryFastEvent;
+	/**
+	 * @brief Fires after every frame when Farneback is off. The tracks are owned by the
+	 * process, copy them if you are going to use them in a different thread.
+	 */
+	ofFastEvent<std::vector<MTPointTrack>> pointTracksFastEvent;
 
 
 	void notifyEvents() override;
@@ -55,23 +122,68 @@ public:
 //	virtual void saveWithSerializer(ofXml& serializer);
 
 	/**
-	 * Returns a cv::Mat with the flow vectors. Input image is unchanged
+	 * Returns a cv::Mat with the flow vectors. Input image is unchanged.
+	 * When Farneback is off the result is a N x 1 CV_32FC4 Mat with one
+	 * (x, y, dx, dy) row per tracked point.
 	 */
 	void process(MTProcessData& processData) override;
 
+	/**
+	 * @brief Returns the dense flow at a position. Only valid when Farneback is on.
+	 */
 	const cv::Vec2f& getFlowPosition(int x, int y);
 
+	/**
+	 * @brief The point tracks of the last frame in sparse mode. Only valid in the processing thread.
+	 */
+	const std::vector<MTPointTrack>& getPointTracks() { return pointTracks; }
+
+	/**
+	 * @brief The summary of the last flow field. Only valid in the processing thread.
+	 */
+	const MTFlowSummary& getFlowSummary() { return flowSummary; }
+
 	std::shared_ptr<MTVideoProcessUI> createUI() override;
 
 private:
 	ofxCv::FlowFarneback fb;
-	ofxCv::FlowPyrLK lk;
-	ofxCv::Flow* curFlow;
 	ofxCv::RunningBackground rb;
 	cv::Mat fgMaskMOG2; //fg mask fg mask generated by MOG2 method
 	cv::Ptr<cv::BackgroundSubtractor> pMOG2;
 	cv::Mat workingImage;
+	cv::Mat zeroFlow;
+	cv::Mat cellEnergy;
+	cv::Mat cellMaxMagnitude;
+	MTFlowSummary flowSummary;
 
+	/**
+	 * @brief Computes the grid averages, total energy and magnitude statistics of the flow
+	 * field in a single pass.
+	 */
+	void computeFlowSummary(const cv::Mat& flow);
+
+	// Sparse mode
+	std::vector<MTPointTrack> pointTracks;
+	std::vector<cv::Mat> previousPyramid;
+	std::vector<cv::Mat> currentPyramid;
+	std::vector<cv::Point2f> previousPoints;
+	std::vector<cv::Point2f> currentPoints;
+	std::vector<cv::Point2f> detectedPoints;
+	std::vector<uchar> trackStatus;
+	std::vector<float> trackError;
+	cv::Mat featureMask;
+	int pyramidWinSize = 0;
+	int pyramidLevels = 0;
+	int framesSinceDetection = 0;
+	int nextTrackId = 0;
+
+	/**
+	 * @brief Tracks the existing points with pyramidal LK, and only re-detects features
+	 * every lkRedetectInterval frames or when fewer than lkMinTracks points survive.
+	 */
+	void processSparse(MTProcessData& processData);
+	void detectFeatures(const cv::Mat& gray, const cv::Mat& mask);
+	void resetTracks();
 
 };
 
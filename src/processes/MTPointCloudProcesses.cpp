@@ -0,0 +1,468 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#include <MTVideoInputStream.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <limits>
+#include "MTPointCloudProcesses.hpp"
+
+namespace
+{
+	/**
+	 * Copies the points of input for which keep() is true to output. Blocks of 4 points that are
+	 * all kept (the common case) are copied with vector stores.
+	 */
+	template<typename Predicate>
+	void selectPoints(const MTPointCloud& input, MTPointCloud& output, const Predicate& keep)
+	{
+		const size_t count = input.size();
+		output.resize(count);
+		size_t written = 0;
+		size_t i = 0;
+
+#if CV_SIMD128
+		for (; i + 4 <= count; i += 4)
+		{
+			cv::v_float32x4 x = cv::v_load(&input.x[i]);
+			cv::v_float32x4 y = cv::v_load(&input.y[i]);
+			cv::v_float32x4 z = cv::v_load(&input.z[i]);
+			int mask = cv::v_signmask(keep(x, y, z));
+			if (mask == 0xF)
+			{
+				cv::v_store(&output.x[written], x);
+				cv::v_store(&output.y[written], y);
+				cv::v_store(&output.z[written], z);
+				written += 4;
+			}
+			else if (mask != 0)
+			{
+				for (int k = 0; k < 4; k++)
+				{
+					if ((mask & (1 << k)) == 0) continue;
+					output.x[written] = input.x[i + k];
+					output.y[written] = input.y[i + k];
+					output.z[written] = input.z[i + k];
+					written++;
+				}
+			}
+		}
+#endif
+		for (; i < count; i++)
+		{
+			if (!keep(input.x[i], input.y[i], input.z[i])) continue;
+			output.x[written] = input.x[i];
+			output.y[written] = input.y[i];
+			output.z[written] = input.z[i];
+			written++;
+		}
+
+		output.resize(written);
+	}
+
+	struct InsideBox
+	{
+		glm::vec3 min;
+		glm::vec3 max;
+
+#if CV_SIMD128
+		cv::v_float32x4 operator()(const cv::v_float32x4& x, const cv::v_float32x4& y, const cv::v_float32x4& z) const
+		{
+			return (x >= cv::v_setall_f32(min.x)) & (x <= cv::v_setall_f32(max.x)) &
+				   (y >= cv::v_setall_f32(min.y)) & (y <= cv::v_setall_f32(max.y)) &
+				   (z >= cv::v_setall_f32(min.z)) & (z <= cv::v_setall_f32(max.z));
+		}
+#endif
+
+		bool operator()(float x, float y, float z) const
+		{
+			return x >= min.x && x <= max.x && y >= min.y && y <= max.y && z >= min.z && z <= max.z;
+		}
+	};
+
+	struct AbovePlane
+	{
+		cv::Vec4f plane;
+		float threshold;
+
+#if CV_SIMD128
+		cv::v_float32x4 operator()(const cv::v_float32x4& x, const cv::v_float32x4& y, const cv::v_float32x4& z) const
+		{
+			cv::v_float32x4 distance = cv::v_fma(cv::v_setall_f32(plane[0]), x,
+												 cv::v_fma(cv::v_setall_f32(plane[1]), y,
+														   cv::v_fma(cv::v_setall_f32(plane[2]), z,
+																	 cv::v_setall_f32(plane[3]))));
+			return distance > cv::v_setall_f32(threshold);
+		}
+#endif
+
+		bool operator()(float x, float y, float z) const
+		{
+			return plane[0] * x + plane[1] * y + plane[2] * z + plane[3] > threshold;
+		}
+	};
+}
+
+#pragma mark MTPointCloudProcess
+
+MTPointCloudProcess::MTPointCloudProcess(std::string name, std::string typeName) :
+		MTVideoProcess(name, typeName)
+{}
+
+void MTPointCloudProcess::process(MTProcessData& processData)
+{
+	hasOutput = false;
+	if (processData.pointCloud == nullptr) return;
+
+	// Someone kept the last output, leave it to them:
+	if (output == nullptr || output.use_count() > 1)
+	{
+		output = std::make_shared<MTPointCloud>();
+	}
+
+	output->resize(0);
+	output->groundPlane = processData.pointCloud->groundPlane;
+	processPointCloud(*processData.pointCloud, *output);
+	processData.pointCloud = output;
+	hasOutput = true;
+}
+
+void MTPointCloudProcess::notifyEvents()
+{
+	MTVideoProcess::notifyEvents();
+	if (hasOutput) ofNotifyEvent(pointCloudFastEvent, *output, this);
+}
+
+#pragma mark MTPointCloudVoxelGrid
+
+MTPointCloudVoxelGrid::MTPointCloudVoxelGrid() :
+		MTPointCloudProcess("Point Cloud Voxel Grid", "MTPointCloudVoxelGrid")
+{
+	parameters.add(leafSize.set("Leaf Size", 0.05, 0.005, 0.5));
+}
+
+void MTPointCloudVoxelGrid::processPointCloud(const MTPointCloud& input, MTPointCloud& output)
+{
+	const size_t count = input.size();
+	const float inverseLeaf = 1.0f / leafSize;
+	cellX.resize(count);
+	cellY.resize(count);
+	cellZ.resize(count);
+
+	// Voxel coordinates of every point:
+	size_t i = 0;
+#if CV_SIMD128
+	const cv::v_float32x4 vInverseLeaf = cv::v_setall_f32(inverseLeaf);
+	for (; i + 4 <= count; i += 4)
+	{
+		cv::v_store(&cellX[i], cv::v_floor(cv::v_load(&input.x[i]) * vInverseLeaf));
+		cv::v_store(&cellY[i], cv::v_floor(cv::v_load(&input.y[i]) * vInverseLeaf));
+		cv::v_store(&cellZ[i], cv::v_floor(cv::v_load(&input.z[i]) * vInverseLeaf));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		cellX[i] = cvFloor(input.x[i] * inverseLeaf);
+		cellY[i] = cvFloor(input.y[i] * inverseLeaf);
+		cellZ[i] = cvFloor(input.z[i] * inverseLeaf);
+	}
+
+	// Sum the points of each voxel. Keys pack 21 bits per axis, which is plenty at any leaf size:
+	const int64_t offset = 1 << 20;
+	const uint64_t mask = (1 << 21) - 1;
+	voxels.clear();
+	counts.clear();
+	for (i = 0; i < count; i++)
+	{
+		uint64_t key = (((uint64_t) (cellX[i] + offset) & mask) << 42) |
+					   (((uint64_t) (cellY[i] + offset) & mask) << 21) |
+					   ((uint64_t) (cellZ[i] + offset) & mask);
+		auto inserted = voxels.emplace(key, (uint32_t) counts.size());
+		if (inserted.second)
+		{
+			output.x.push_back(input.x[i]);
+			output.y.push_back(input.y[i]);
+			output.z.push_back(input.z[i]);
+			counts.push_back(1);
+		}
+		else
+		{
+			uint32_t v = inserted.first->second;
+			output.x[v] += input.x[i];
+			output.y[v] += input.y[i];
+			output.z[v] += input.z[i];
+			counts[v]++;
+		}
+	}
+
+	// Sums to centroids:
+	const size_t voxelCount = counts.size();
+	i = 0;
+#if CV_SIMD128
+	for (; i + 4 <= voxelCount; i += 4)
+	{
+		cv::v_float32x4 n = cv::v_cvt_f32(cv::v_load(&counts[i]));
+		cv::v_store(&output.x[i], cv::v_load(&output.x[i]) / n);
+		cv::v_store(&output.y[i], cv::v_load(&output.y[i]) / n);
+		cv::v_store(&output.z[i], cv::v_load(&output.z[i]) / n);
+	}
+#endif
+	for (; i < voxelCount; i++)
+	{
+		float n = (float) counts[i];
+		output.x[i] /= n;
+		output.y[i] /= n;
+		output.z[i] /= n;
+	}
+}
+
+#pragma mark MTPointCloudFloorRemoval
+
+MTPointCloudFloorRemoval::MTPointCloudFloorRemoval() :
+		MTPointCloudProcess("Point Cloud Floor Removal", "MTPointCloudFloorRemoval")
+{
+	parameters.add(iterations.set("RANSAC Iterations", 100, 10, 1000),
+				   distanceThreshold.set("Distance Threshold", 0.02, 0.002, 0.2),
+				   maxNormalAngle.set("Max Normal Angle", 30, 0, 90),
+				   sampleSize.set("Sample Size", 4096, 256, 32768));
+}
+
+void MTPointCloudFloorRemoval::setup()
+{
+	MTPointCloudProcess::setup();
+	plane = cv::Vec4f(0, 0, 0, 0);
+}
+
+int MTPointCloudFloorRemoval::countInliers(const MTPointCloud& cloud, const cv::Vec4f& candidate)
+{
+	const size_t count = cloud.size();
+	const float threshold = distanceThreshold;
+	int inliers = 0;
+	size_t i = 0;
+
+#if CV_SIMD128
+	const cv::v_float32x4 a = cv::v_setall_f32(candidate[0]);
+	const cv::v_float32x4 b = cv::v_setall_f32(candidate[1]);
+	const cv::v_float32x4 c = cv::v_setall_f32(candidate[2]);
+	const cv::v_float32x4 d = cv::v_setall_f32(candidate[3]);
+	const cv::v_float32x4 vThreshold = cv::v_setall_f32(threshold);
+	cv::v_int32x4 vInliers = cv::v_setzero_s32();
+	for (; i + 4 <= count; i += 4)
+	{
+		cv::v_float32x4 distance = cv::v_fma(a, cv::v_load(&cloud.x[i]),
+											 cv::v_fma(b, cv::v_load(&cloud.y[i]),
+													   cv::v_fma(c, cv::v_load(&cloud.z[i]), d)));
+		// True lanes are -1:
+		vInliers -= cv::v_reinterpret_as_s32(cv::v_abs(distance) < vThreshold);
+	}
+	inliers = cv::v_reduce_sum(vInliers);
+#endif
+	for (; i < count; i++)
+	{
+		float distance = candidate[0] * cloud.x[i] + candidate[1] * cloud.y[i] +
+						 candidate[2] * cloud.z[i] + candidate[3];
+		if (std::abs(distance) < threshold) inliers++;
+	}
+
+	return inliers;
+}
+
+void MTPointCloudFloorRemoval::processPointCloud(const MTPointCloud& input, MTPointCloud& output)
+{
+	const size_t count = input.size();
+	if (count < 3)
+	{
+		output.x = input.x;
+		output.y = input.y;
+		output.z = input.z;
+		return;
+	}
+
+	// Candidates are scored on a random subsample, gathered once per frame:
+	const size_t samples = std::min(count, (size_t) sampleSize.get());
+	sample.resize(samples);
+	for (size_t s = 0; s < samples; s++)
+	{
+		auto index = (size_t) rng.uniform(0, (int) count);
+		sample.x[s] = input.x[index];
+		sample.y[s] = input.y[index];
+		sample.z[s] = input.z[index];
+	}
+
+	// The floor normal has to point up, i.e. towards -Y in camera coordinates:
+	const float minUp = std::cos(maxNormalAngle.get() * (float) CV_PI / 180.0f);
+	cv::Vec4f bestPlane = plane;
+	int bestInliers = plane != cv::Vec4f(0, 0, 0, 0) ? countInliers(sample, plane) : 0;
+
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		int i0 = rng.uniform(0, (int) samples);
+		int i1 = rng.uniform(0, (int) samples);
+		int i2 = rng.uniform(0, (int) samples);
+		cv::Vec3f p0(sample.x[i0], sample.y[i0], sample.z[i0]);
+		cv::Vec3f p1(sample.x[i1], sample.y[i1], sample.z[i1]);
+		cv::Vec3f p2(sample.x[i2], sample.y[i2], sample.z[i2]);
+		cv::Vec3f normal = (p1 - p0).cross(p2 - p0);
+		float length = (float) cv::norm(normal);
+		if (length < 1e-6f) continue;
+		normal /= length;
+		if (normal[1] > 0) normal = -normal;
+		if (-normal[1] < minUp) continue;
+
+		cv::Vec4f candidate(normal[0], normal[1], normal[2], -normal.dot(p0));
+		int inliers = countInliers(sample, candidate);
+		if (inliers > bestInliers)
+		{
+			bestInliers = inliers;
+			bestPlane = candidate;
+		}
+	}
+
+	plane = bestInliers > 0 ? bestPlane : cv::Vec4f(0, 0, 0, 0);
+	if (plane == cv::Vec4f(0, 0, 0, 0))
+	{
+		output.x = input.x;
+		output.y = input.y;
+		output.z = input.z;
+		return;
+	}
+
+	// Keep what is above the floor:
+	selectPoints(input, output, AbovePlane{plane, distanceThreshold.get()});
+	output.groundPlane = plane;
+}
+
+#pragma mark MTPointCloudCrop
+
+MTPointCloudCrop::MTPointCloudCrop() :
+		MTPointCloudProcess("Point Cloud Crop", "MTPointCloudCrop")
+{
+	parameters.add(boxMin.set("Box Min", glm::vec3(-1, -1, 0), glm::vec3(-10), glm::vec3(10)),
+				   boxMax.set("Box Max", glm::vec3(1, 1, 4), glm::vec3(-10), glm::vec3(10)));
+}
+
+void MTPointCloudCrop::processPointCloud(const MTPointCloud& input, MTPointCloud& output)
+{
+	selectPoints(input, output, InsideBox{boxMin.get(), boxMax.get()});
+}
+
+#pragma mark MTPointCloudHeightMap
+
+MTPointCloudHeightMap::MTPointCloudHeightMap() :
+		MTVideoProcess("Point Cloud Height Map", "MTPointCloudHeightMap")
+{
+	parameters.add(areaMin.set("Area Min", glm::vec2(-2, 0), glm::vec2(-10), glm::vec2(10)),
+				   areaMax.set("Area Max", glm::vec2(2, 4), glm::vec2(-10), glm::vec2(10)),
+				   cellSize.set("Cell Size", 0.02, 0.005, 0.2),
+				   heightMin.set("Min Height", 0, -3, 3),
+				   heightMax.set("Max Height", 2, -3, 3));
+}
+
+void MTPointCloudHeightMap::process(MTProcessData& processData)
+{
+	if (processData.pointCloud == nullptr) return;
+	const MTPointCloud& cloud = *processData.pointCloud;
+
+	const float inverseCell = 1.0f / cellSize;
+	const glm::vec2 minimum = areaMin;
+	const int cols = std::max(1, std::min(4096, (int) std::ceil((areaMax->x - minimum.x) * inverseCell)));
+	const int rows = std::max(1, std::min(4096, (int) std::ceil((areaMax->y - minimum.y) * inverseCell)));
+	// Heights above the ground plane, or along -Y:
+	cv::Vec4f plane = cloud.hasGroundPlane() ? cloud.groundPlane : cv::Vec4f(0, -1, 0, 0);
+
+	heightMap.create(rows, cols, CV_32FC1);
+	heightMap.setTo(cv::Scalar::all(std::numeric_limits<float>::lowest()));
+
+	// Cell index and height of every point, -1 for the points outside of the area:
+	const size_t count = cloud.size();
+	cells.resize(count);
+	heights.resize(count);
+	size_t i = 0;
+#if CV_SIMD128
+	const cv::v_float32x4 vInverseCell = cv::v_setall_f32(inverseCell);
+	const cv::v_float32x4 vMinX = cv::v_setall_f32(minimum.x);
+	const cv::v_float32x4 vMinZ = cv::v_setall_f32(minimum.y);
+	const cv::v_int32x4 vCols = cv::v_setall_s32(cols);
+	const cv::v_int32x4 vRows = cv::v_setall_s32(rows);
+	const cv::v_int32x4 vZero = cv::v_setzero_s32();
+	const cv::v_int32x4 vOutside = cv::v_setall_s32(-1);
+	const cv::v_float32x4 a = cv::v_setall_f32(plane[0]);
+	const cv::v_float32x4 b = cv::v_setall_f32(plane[1]);
+	const cv::v_float32x4 c = cv::v_setall_f32(plane[2]);
+	const cv::v_float32x4 d = cv::v_setall_f32(plane[3]);
+	for (; i + 4 <= count; i += 4)
+	{
+		cv::v_float32x4 x = cv::v_load(&cloud.x[i]);
+		cv::v_float32x4 y = cv::v_load(&cloud.y[i]);
+		cv::v_float32x4 z = cv::v_load(&cloud.z[i]);
+		cv::v_int32x4 col = cv::v_floor((x - vMinX) * vInverseCell);
+		cv::v_int32x4 row = cv::v_floor((z - vMinZ) * vInverseCell);
+		cv::v_int32x4 inside = (col >= vZero) & (col < vCols) & (row >= vZero) & (row < vRows);
+		cv::v_store(&cells[i], cv::v_select(inside, row * vCols + col, vOutside));
+		cv::v_store(&heights[i], cv::v_fma(a, x, cv::v_fma(b, y, cv::v_fma(c, z, d))));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		int col = cvFloor((cloud.x[i] - minimum.x) * inverseCell);
+		int row = cvFloor((cloud.z[i] - minimum.y) * inverseCell);
+		bool inside = col >= 0 && col < cols && row >= 0 && row < rows;
+		cells[i] = inside ? row * cols + col : -1;
+		heights[i] = plane[0] * cloud.x[i] + plane[1] * cloud.y[i] + plane[2] * cloud.z[i] + plane[3];
+	}
+
+	// Scatter, keeping the highest point of each cell:
+	float* map = heightMap.ptr<float>();
+	for (i = 0; i < count; i++)
+	{
+		int cell = cells[i];
+		if (cell >= 0 && heights[i] > map[cell]) map[cell] = heights[i];
+	}
+
+	// 8-bit version, and NaN for the empty cells:
+	processBuffer.create(rows, cols, CV_8UC1);
+	uchar* image = processBuffer.ptr<uchar>();
+	const float low = heightMin;
+	const float scale = 255.0f / std::max(1e-6f, heightMax.get() - heightMin.get());
+	const float empty = std::numeric_limits<float>::lowest();
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	const int total = rows * cols;
+	int k = 0;
+#if CV_SIMD128
+	const cv::v_float32x4 vLow = cv::v_setall_f32(low);
+	const cv::v_float32x4 vScale = cv::v_setall_f32(scale);
+	const cv::v_float32x4 vEmpty = cv::v_setall_f32(empty);
+	const cv::v_float32x4 vNan = cv::v_setall_f32(nan);
+	for (; k + 8 <= total; k += 8)
+	{
+		cv::v_float32x4 h0 = cv::v_load(map + k);
+		cv::v_float32x4 h1 = cv::v_load(map + k + 4);
+		// Empty cells are far below heightMin and saturate to 0:
+		cv::v_int16x8 scaled = cv::v_pack(cv::v_round((h0 - vLow) * vScale), cv::v_round((h1 - vLow) * vScale));
+		cv::v_pack_u_store(image + k, scaled);
+		cv::v_store(map + k, cv::v_select(h0 == vEmpty, vNan, h0));
+		cv::v_store(map + k + 4, cv::v_select(h1 == vEmpty, vNan, h1));
+	}
+#endif
+	for (; k < total; k++)
+	{
+		if (map[k] == empty)
+		{
+			image[k] = 0;
+			map[k] = nan;
+		}
+		else
+		{
+			image[k] = cv::saturate_cast<uchar>((map[k] - low) * scale);
+		}
+	}
+
+	processOutput = processBuffer;
+	processData.processStream = processOutput;
+	processData.processResult = heightMap;
+}
+
+std::shared_ptr<MTVideoProcessUI> MTPointCloudHeightMap::createUI()
+{
+	return std::make_shared<MTVideoProcessUIWithImage>(shared_from_this(), OF_IMAGE_GRAYSCALE);
+}
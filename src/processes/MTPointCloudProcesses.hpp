@@ -0,0 +1,145 @@
+//
+// Created by Cristobal Mendoza on 10/19/26.
+//
+
+#ifndef NERVOUSSTRUCTUREOF_MTPOINTCLOUDPROCESSES_HPP
+#define NERVOUSSTRUCTUREOF_MTPOINTCLOUDPROCESSES_HPP
+
+#include <unordered_map>
+#include "MTVideoProcess.hpp"
+#include "MTVideoProcessUI.hpp"
+#include "MTPointCloud.hpp"
+
+/**
+ * @brief Base class for processes that transform MTProcessData::pointCloud. The output cloud
+ * is owned by the process and replaces the input in MTProcessData, the same way processStream
+ * is passed along. Frames without a point cloud are left untouched.
+ */
+class MTPointCloudProcess : public MTVideoProcess
+{
+public:
+	/**
+	 * @brief Fires after every frame with the output cloud. The cloud is owned by the process,
+	 * copy it if you need it outside of the listener.
+	 */
+	ofFastEvent<MTPointCloud> pointCloudFastEvent;
+
+	MTPointCloudProcess(std::string name, std::string typeName);
+	void process(MTProcessData& processData) override;
+	void notifyEvents() override;
+
+	bool needsImage() override
+	{ return false; }
+
+protected:
+	std::shared_ptr<MTPointCloud> output;
+	bool hasOutput = false;
+
+	/**
+	 * @param output Empty, except for the ground plane which is copied from the input.
+	 */
+	virtual void processPointCloud(const MTPointCloud& input, MTPointCloud& output) = 0;
+};
+
+/**
+ * @brief Downsamples the cloud to one point per voxel, the centroid of the points that fall in it.
+ */
+class MTPointCloudVoxelGrid : public MTPointCloudProcess
+{
+public:
+	ofParameter<float> leafSize;
+
+	MTPointCloudVoxelGrid();
+
+protected:
+	std::vector<int> cellX;
+	std::vector<int> cellY;
+	std::vector<int> cellZ;
+	std::vector<int> counts;
+	std::unordered_map<uint64_t, uint32_t> voxels;
+
+	void processPointCloud(const MTPointCloud& input, MTPointCloud& output) override;
+};
+
+/**
+ * @brief Finds the floor with RANSAC and removes it, along with everything below it.
+ * Candidate planes are scored on a random subsample of the cloud, and the plane found on
+ * the previous frame is always one of the candidates, which keeps it stable over time.
+ * The plane is published in MTPointCloud::groundPlane for the processes that follow.
+ */
+class MTPointCloudFloorRemoval : public MTPointCloudProcess
+{
+public:
+	ofParameter<int> iterations;
+	ofParameter<float> distanceThreshold;
+	/// Maximum angle between the floor normal and the camera's Y axis, in degrees
+	ofParameter<float> maxNormalAngle;
+	ofParameter<int> sampleSize;
+
+	MTPointCloudFloorRemoval();
+	void setup() override;
+
+	/**
+	 * @return The last floor plane (a, b, c, d), or all zeros if none was found.
+	 */
+	cv::Vec4f getFloorPlane() const
+	{ return plane; }
+
+protected:
+	cv::RNG rng;
+	MTPointCloud sample;
+	cv::Vec4f plane = cv::Vec4f(0, 0, 0, 0);
+
+	void processPointCloud(const MTPointCloud& input, MTPointCloud& output) override;
+	int countInliers(const MTPointCloud& cloud, const cv::Vec4f& candidate);
+};
+
+/**
+ * @brief Keeps the points inside an axis-aligned box.
+ */
+class MTPointCloudCrop : public MTPointCloudProcess
+{
+public:
+	ofParameter<glm::vec3> boxMin;
+	ofParameter<glm::vec3> boxMax;
+
+	MTPointCloudCrop();
+
+protected:
+	void processPointCloud(const MTPointCloud& input, MTPointCloud& output) override;
+};
+
+/**
+ * @brief Projects the cloud onto a top-down grid over the camera's X/Z plane, keeping the highest
+ * point of each cell. Heights are measured from MTPointCloud::groundPlane if there is one
+ * (see MTPointCloudFloorRemoval), or along -Y otherwise.
+ * The metric CV_32FC1 map goes to processResult (empty cells are NaN), and an 8-bit version
+ * scaled between "Min Height" and "Max Height" goes to processStream, so that image processes
+ * like Threshold or the Blob Tracker can follow.
+ */
+class MTPointCloudHeightMap : public MTVideoProcess
+{
+public:
+	ofParameter<glm::vec2> areaMin;
+	ofParameter<glm::vec2> areaMax;
+	ofParameter<float> cellSize;
+	ofParameter<float> heightMin;
+	ofParameter<float> heightMax;
+
+	MTPointCloudHeightMap();
+	void process(MTProcessData& processData) override;
+	std::shared_ptr<MTVideoProcessUI> createUI() override;
+
+	/**
+	 * @brief The metric height map. Owned by the process, clone it if you need it outside of
+	 * the processing thread.
+	 */
+	const cv::Mat& getHeightMap() { return heightMap; }
+
+protected:
+	cv::Mat heightMap;
+	std::vector<int> cells;
+	std::vector<float> heights;
+};
+
+#endif //NERVOUSSTRUCTUREOF_MTPOINTCLOUDPROCESSES_HPP
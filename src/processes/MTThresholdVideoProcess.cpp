@@ -6,6 +6,7 @@
 #include "ofxCv.h"
 #include "MTVideoInputStream.hpp"
 #include "MTAppFrameworkUtils.hpp"
+#include <opencv2/core/hal/intrin.hpp>
 
 #pragma mark Threshold
 
@@ -13,9 +14,129 @@
 /// THRESHOLD
 ///////////////////////////////////
 
+namespace
+{
+	template<typename T>
+	struct ThresholdTraits;
+
+	template<>
+	struct ThresholdTraits<uchar>
+	{
+		typedef int Sum;
+		// Otsu histogram bins are (value >> HistogramShift):
+		static const int HistogramShift = 0;
+	};
+
+	template<>
+	struct ThresholdTraits<ushort>
+	{
+		typedef int64_t Sum;
+		static const int HistogramShift = 4;
+	};
+
+	// 255 where src > level, 0 elsewhere:
+	inline void thresholdRow(const uchar* src, uchar* dst, int cols, uchar level)
+	{
+		int x = 0;
+#if CV_SIMD128
+		const cv::v_uint8x16 vLevel = cv::v_setall_u8(level);
+		for (; x <= cols - cv::v_uint8x16::nlanes; x += cv::v_uint8x16::nlanes)
+		{
+			cv::v_store(dst + x, cv::v_load(src + x) > vLevel);
+		}
+#endif
+		for (; x < cols; x++)
+		{
+			dst[x] = src[x] > level ? 255 : 0;
+		}
+	}
+
+	inline void thresholdRow(const ushort* src, uchar* dst, int cols, ushort level)
+	{
+		int x = 0;
+#if CV_SIMD128
+		const cv::v_uint16x8 vLevel = cv::v_setall_u16(level);
+		for (; x <= cols - cv::v_uint8x16::nlanes; x += cv::v_uint8x16::nlanes)
+		{
+			// The 0xFFFF lanes saturate to 0xFF when packed:
+			cv::v_store(dst + x, cv::v_pack(cv::v_load(src + x) > vLevel,
+											cv::v_load(src + x + cv::v_uint16x8::nlanes) > vLevel));
+		}
+#endif
+		for (; x < cols; x++)
+		{
+			dst[x] = src[x] > level ? 255 : 0;
+		}
+	}
+
+	// sums += add - sub
+	inline void slideColumns(const uchar* add, const uchar* sub, int* sums, int cols)
+	{
+		int x = 0;
+#if CV_SIMD128
+		for (; x <= cols - cv::v_uint8x16::nlanes; x += cv::v_uint8x16::nlanes)
+		{
+			cv::v_uint16x8 a0, a1, b0, b1;
+			cv::v_expand(cv::v_load(add + x), a0, a1);
+			cv::v_expand(cv::v_load(sub + x), b0, b1);
+			cv::v_int32x4 d[4];
+			cv::v_expand(cv::v_reinterpret_as_s16(a0) - cv::v_reinterpret_as_s16(b0), d[0], d[1]);
+			cv::v_expand(cv::v_reinterpret_as_s16(a1) - cv::v_reinterpret_as_s16(b1), d[2], d[3]);
+			for (int i = 0; i < 4; i++)
+			{
+				int* p = sums + x + i * cv::v_int32x4::nlanes;
+				cv::v_store(p, cv::v_load(p) + d[i]);
+			}
+		}
+#endif
+		for (; x < cols; x++)
+		{
+			sums[x] += add[x] - sub[x];
+		}
+	}
+
+	inline void slideColumns(const ushort* add, const ushort* sub, int* sums, int cols)
+	{
+		int x = 0;
+#if CV_SIMD128
+		for (; x <= cols - cv::v_uint16x8::nlanes; x += cv::v_uint16x8::nlanes)
+		{
+			cv::v_uint32x4 a0, a1, b0, b1;
+			cv::v_expand(cv::v_load(add + x), a0, a1);
+			cv::v_expand(cv::v_load(sub + x), b0, b1);
+			cv::v_store(sums + x, cv::v_load(sums + x) +
+								  (cv::v_reinterpret_as_s32(a0) - cv::v_reinterpret_as_s32(b0)));
+			cv::v_store(sums + x + cv::v_int32x4::nlanes, cv::v_load(sums + x + cv::v_int32x4::nlanes) +
+														  (cv::v_reinterpret_as_s32(a1) - cv::v_reinterpret_as_s32(b1)));
+		}
+#endif
+		for (; x < cols; x++)
+		{
+			sums[x] += int(add[x]) - int(sub[x]);
+		}
+	}
+}
+
 MTThresholdVideoProcess::MTThresholdVideoProcess() : MTVideoProcess("Threshold", "MTThresholdVideoProcess")
 {
-	parameters.add(threshold.set("Threshold", 127, 0, 255));
+	// Written into directly every frame, so it can be shared without a copy:
+	registerOutputBuffer(processOutput);
+	parameters.add(mode.set("Mode", 0, 0, 2),
+				   threshold.set("Threshold", 127, 0, 255),
+				   depthThreshold.set("Depth Threshold", 1000, 0, 65535),
+				   levelSmoothing.set("Level Smoothing", 0.9, 0, 0.99),
+				   adaptiveRadius.set("Adaptive Radius", 15, 1, 100),
+				   adaptiveOffset.set("Adaptive Offset", 5, -50, 50));
+	addEventListener(mode.newListener([this](int)
+									  {
+										  levelIsValid = false;
+									  }));
+}
+
+void MTThresholdVideoProcess::setup()
+{
+	MTVideoProcess::setup();
+	levelIsValid = false;
 }
 
 void MTThresholdVideoProcess::process(MTProcessData& processData)
@@ -29,12 +150,203 @@ void MTThresholdVideoProcess::process(MTProcessData& processData)
 	{
 		processBuffer = streamBuffer;
 	}
-	cv::threshold(processBuffer, processOutput, threshold.get(), threshold.getMax(),
-				  cv::THRESH_BINARY);
+
+	if (processBuffer.depth() == CV_16U)
+	{
+		thresholdT<ushort>(processBuffer, processOutput, depthThreshold);
+	}
+	else
+	{
+		thresholdT<uchar>(processBuffer, processOutput, threshold);
+	}
+
 	processData.processStream = processOutput;
 	processData.processResult = processOutput;
 }
 
+template<typename T>
+void MTThresholdVideoProcess::thresholdT(const cv::Mat& src, cv::Mat& dst, int manualLevel)
+{
+	switch (mode)
+	{
+		case Otsu:
+			thresholdOtsu<T>(src, dst, manualLevel);
+			break;
+		case Adaptive:
+			thresholdAdaptive<T>(src, dst);
+			break;
+		default:
+		{
+			level = manualLevel;
+			dst.create(src.size(), CV_8UC1);
+			const T thresholdLevel = cv::saturate_cast<T>(manualLevel);
+			cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range)
+			{
+				for (int y = range.start; y < range.end; y++)
+				{
+					thresholdRow(src.ptr<T>(y), dst.ptr<uchar>(y), src.cols, thresholdLevel);
+				}
+			});
+			break;
+		}
+	}
+}
+
+template<typename T>
+void MTThresholdVideoProcess::thresholdOtsu(const cv::Mat& src, cv::Mat& dst, int manualLevel)
+{
+	const int shift = ThresholdTraits<T>::HistogramShift;
+	const int bins = (std::numeric_limits<T>::max() >> shift) + 1;
+
+	// There is no histogram before the first frame, so start from the manual level:
+	if (!levelIsValid) level = manualLevel;
+
+	dst.create(src.size(), CV_8UC1);
+	const int stripHeight = 32;
+	const int strips = (src.rows + stripHeight - 1) / stripHeight;
+	stripHistograms.resize(strips);
+	const T thresholdLevel = cv::saturate_cast<T>(std::floor(level));
+
+	cv::parallel_for_(cv::Range(0, strips), [&](const cv::Range& range)
+	{
+		for (int s = range.start; s < range.end; s++)
+		{
+			auto& histogram = stripHistograms[s];
+			histogram.assign(bins, 0);
+			int rowEnd = std::min(src.rows, (s + 1) * stripHeight);
+			for (int y = s * stripHeight; y < rowEnd; y++)
+			{
+				const T* input = src.ptr<T>(y);
+				thresholdRow(input, dst.ptr<uchar>(y), src.cols, thresholdLevel);
+
+				// The row is still in cache:
+				for (int x = 0; x < src.cols; x++)
+				{
+					histogram[input[x] >> shift]++;
+				}
+			}
+		}
+	});
+
+	std::vector<int> histogram(bins, 0);
+	for (const auto& h : stripHistograms)
+	{
+		for (int i = 0; i < bins; i++) histogram[i] += h[i];
+	}
+
+	// Otsu's method: pick the level that maximizes the between-class variance.
+	double total = (double) src.total();
+	double sum = 0;
+	for (int i = 0; i < bins; i++) sum += i * (double) histogram[i];
+
+	double sumBackground = 0;
+	double weightBackground = 0;
+	double maxVariance = -1;
+	int otsuBin = -1;
+	for (int t = 0; t < bins; t++)
+	{
+		weightBackground += histogram[t];
+		if (weightBackground == 0) continue;
+		double weightForeground = total - weightBackground;
+		if (weightForeground == 0) break;
+		sumBackground += t * (double) histogram[t];
+		double meanBackground = sumBackground / weightBackground;
+		double meanForeground = (sum - sumBackground) / weightForeground;
+		double delta = meanBackground - meanForeground;
+		double variance = weightBackground * weightForeground * delta * delta;
+		if (variance > maxVariance)
+		{
+			maxVariance = variance;
+			otsuBin = t;
+		}
+	}
+
+	// A flat image has no level to pick:
+	if (otsuBin < 0) return;
+	// Everything in the bins up to otsuBin is background:
+	float otsuLevel = float(((otsuBin + 1) << shift) - 1);
+
+	if (levelIsValid)
+	{
+		level = levelSmoothing * level + (1 - levelSmoothing) * otsuLevel;
+	}
+	else
+	{
+		level = otsuLevel;
+		levelIsValid = true;
+	}
+}
+
+template<typename T>
+void MTThresholdVideoProcess::thresholdAdaptive(const cv::Mat& src, cv::Mat& dst)
+{
+	typedef typename ThresholdTraits<T>::Sum Sum;
+	dst.create(src.size(), CV_8UC1);
+	const int radius = adaptiveRadius;
+	const Sum offset = adaptiveOffset;
+	const Sum area = (2 * radius + 1) * (2 * radius + 1);
+	const int rows = src.rows;
+	const int cols = src.cols;
+	// Every strip starts by summing 2 * radius + 1 rows, keep that small compared to the strip:
+	const int stripHeight = std::max(64, 8 * radius);
+	const int strips = (rows + stripHeight - 1) / stripHeight;
+	level = -1;
+
+	auto clampRow = [rows](int y)
+	{
+		return std::min(std::max(y, 0), rows - 1);
+	};
+
+	cv::parallel_for_(cv::Range(0, strips), [&](const cv::Range& range)
+	{
+		thread_local std::vector<int> columnSums;
+		thread_local std::vector<Sum> prefix;
+		columnSums.resize(cols);
+		prefix.resize(cols + 2 * radius + 2);
+
+		for (int s = range.start; s < range.end; s++)
+		{
+			int rowStart = s * stripHeight;
+			int rowEnd = std::min(rows, rowStart + stripHeight);
+
+			std::fill(columnSums.begin(), columnSums.end(), 0);
+			for (int k = -radius; k <= radius; k++)
+			{
+				const T* row = src.ptr<T>(clampRow(rowStart + k));
+				for (int x = 0; x < cols; x++) columnSums[x] += row[x];
+			}
+
+			for (int y = rowStart; y < rowEnd; y++)
+			{
+				if (y > rowStart)
+				{
+					// Slide the vertical window down one row:
+					slideColumns(src.ptr<T>(clampRow(y + radius)),
+								 src.ptr<T>(clampRow(y - radius - 1)),
+								 columnSums.data(), cols);
+				}
+
+				// Horizontal box sums from a prefix sum of the column sums, replicating the edges:
+				prefix[0] = 0;
+				for (int i = 0; i < cols + 2 * radius; i++)
+				{
+					int column = std::min(std::max(i - radius, 0), cols - 1);
+					prefix[i + 1] = prefix[i] + columnSums[column];
+				}
+
+				// src > mean - offset, without dividing by the area:
+				const T* input = src.ptr<T>(y);
+				uchar* output = dst.ptr<uchar>(y);
+				for (int x = 0; x < cols; x++)
+				{
+					Sum boxSum = prefix[x + 2 * radius + 1] - prefix[x];
+					output[x] = (input[x] + offset) * area > boxSum ? 255 : 0;
+				}
+			}
+		}
+	});
+}
+
 std::shared_ptr<MTVideoProcessUI> MTThresholdVideoProcess::createUI()
 {
 	return std::make_shared<MTThresholdVideoProcessUI>(shared_from_this(), OF_IMAGE_GRAYSCALE);
@@ -49,16 +361,30 @@ MTThresholdVideoProcessUI::MTThresholdVideoProcessUI(const std::shared_ptr<MTVid
 													 ofImageType imageType) : MTVideoProcessUIWithImage(videoProcess,
 																										imageType)
 {
-
+	modeLabels = {"Manual", "Otsu", "Adaptive"};
 }
 
 void MTThresholdVideoProcessUI::draw(ofxImGui::Settings& settings)
 {
 	auto vp = videoProcess.lock();
-	MTVideoProcessUIWithImage::draw(settings);
-	for (auto& param : vp->getParameters())
+	auto tp = std::dynamic_pointer_cast<MTThresholdVideoProcess>(vp);
+	drawImage();
+	ofxImGui::AddParameter<bool>(tp->isActive);
+	ofxImGui::AddRadio(tp->mode, modeLabels);
+	switch (tp->mode)
 	{
-		ofxImGui::AddParameter(param);
+		case MTThresholdVideoProcess::Otsu:
+			ofxImGui::AddParameter<float>(tp->levelSmoothing);
+			ImGui::Text("Level: %.1f", tp->getLevel());
+			break;
+		case MTThresholdVideoProcess::Adaptive:
+			ofxImGui::AddParameter<int>(tp->adaptiveRadius);
+			ofxImGui::AddParameter<int>(tp->adaptiveOffset);
+			break;
+		default:
+			ofxImGui::AddParameter<int>(tp->threshold);
+			ofxImGui::AddParameter<int>(tp->depthThreshold);
+			break;
 	}
 }
 
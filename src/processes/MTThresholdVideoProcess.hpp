@@ -13,11 +13,63 @@
 class MTThresholdVideoProcess : public MTVideoProcess
 {
 public:
+	ofParameter<int> mode;
 	ofParameter<int> threshold;
+	/// The manual level for 16-bit streams, e.g. depth in millimetres
+	ofParameter<int> depthThreshold;
+	ofParameter<float> levelSmoothing;
+	ofParameter<int> adaptiveRadius;
+	ofParameter<int> adaptiveOffset;
+
+	enum ThresholdMode
+	{
+		/// A fixed level set by "Threshold", or "Depth Threshold" for 16-bit streams
+		Manual = 0,
+		/// Otsu's level, computed from the histogram of the previous frame and smoothed over time
+		Otsu,
+		/// Each pixel is compared to the mean of its neighborhood
+		Adaptive
+	};
 
 	MTThresholdVideoProcess();
+	void setup() override;
 	void process(MTProcessData& processData) override;
 	std::shared_ptr<MTVideoProcessUI> createUI() override;
+	/// Otsu smooths the level over time
+	bool isStateless() override
+	{ return mode != Otsu; }
+
+	/**
+	 * @brief The level used on the last frame. In Otsu mode this is the smoothed automatic level.
+	 */
+	float getLevel() const { return level; }
+
+protected:
+	float level = 127;
+	bool levelIsValid = false;
+	std::vector<std::vector<int>> stripHistograms;
+
+	/**
+	 * @brief Thresholds 8-bit or 16-bit streams into an 8-bit mask with the current mode.
+	 */
+	template<typename T>
+	void thresholdT(const cv::Mat& src, cv::Mat& dst, int manualLevel);
+
+	/**
+	 * @brief Thresholds at the current level and builds the histogram of the source in the same pass.
+	 * The histogram is then used to pick the level for the next frame, so the frame is only read once.
+	 * 16-bit histograms use 4096 bins.
+	 */
+	template<typename T>
+	void thresholdOtsu(const cv::Mat& src, cv::Mat& dst, int manualLevel);
+
+	/**
+	 * @brief Sets a pixel if it is brighter than the mean of its (2 * radius + 1)^2 neighborhood
+	 * minus the offset. The box sums are kept as running column sums that slide down each strip
+	 * of rows, which gives the same result as an integral image without storing or re-reading one.
+	 */
+	template<typename T>
+	void thresholdAdaptive(const cv::Mat& src, cv::Mat& dst);
 };
 
 class MTThresholdVideoProcessUI : public MTVideoProcessUIWithImage
@@ -25,6 +77,8 @@ class MTThresholdVideoProcessUI : public MTVideoProcessUIWithImage
 public:
 	MTThresholdVideoProcessUI(const std::shared_ptr <MTVideoProcess>& videoProcess, ofImageType imageType);
 	void draw(ofxImGui::Settings& settings) override;
+
+	std::vector<std::string> modeLabels;
 };
 
 #endif
\ No newline at end of file